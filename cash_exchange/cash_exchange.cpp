@@ -18,381 +18,69 @@
  * 8. STL containers
  * 9. Exception Handling
  * 10. Const correctness
+ * 11. Strategy Pattern (pluggable change-making engine)
  *
  * Machine accepts: 5, 10, 20, 50, 100 EUR
  * Exchanges into smaller denominations.
  *
- * @usage
- * g++ -std=c++17 cash_exchange_machine_oop_documented.cpp -o machine
- * ./machine
- */
-
-#include <iostream>
-#include <memory>
-#include <map>
-#include <vector>
-#include <stdexcept>
-
-/* ============================================================
-   ENUM CLASS  →  TYPE SAFETY + STRONG ENUMERATION
-   OOP Concept: Strong typing / Scoped enum
-   ============================================================ */
-
-/**
- * @enum Denomination
- * @brief Represents valid Euro denominations.
- */
-enum class Denomination {
-    EUR_5   = 5,
-    EUR_10  = 10,
-    EUR_20  = 20,
-    EUR_50  = 50,
-    EUR_100 = 100
-};
-
-/* ============================================================
-   INTERFACE (ABSTRACTION)
-   OOP Concept Applied: Abstraction + Polymorphism
-   ============================================================ */
-
-/**
- * @class IMachineState
- * @brief Pure abstract base class (Interface).
+ * Payouts are computed by a change-making engine before any note
+ * leaves the inventory. The default engine tries the bounded greedy
+ * walk first and falls back to a bounded-knapsack DP that respects
+ * the per-denomination counts, so an exchange only fails when no
+ * valid combination exists.
  *
- * OOP Concept:
- * - Abstraction → Defines WHAT to do, not HOW
- * - Polymorphism → Derived classes override behavior
- */
-class IMachineState {
-public:
-
-    /**
-     * @brief Virtual destructor.
-     * Required for polymorphic base classes.
-     */
-    virtual ~IMachineState() = default;
-
-    /**
-     * @brief Insert money event.
-     */
-    virtual void insertMoney(int amount) = 0;
-
-    /**
-     * @brief Exchange event.
-     */
-    virtual void exchange() = 0;
-
-    /**
-     * @brief Returns state name.
-     */
-    virtual const char* name() const = 0;
-};
-
-/* Forward declarations to resolve circular dependencies */
-class IdleState;
-class HasMoneyState;
-
-/* ============================================================
-   CASH INVENTORY
-   OOP Concept Applied: Encapsulation
-   ============================================================ */
-
-/**
- * @class CashInventory
- * @brief Manages machine cash storage.
+ * The machine itself lives in the headers next to this file:
+ * - ../common/money.h      → Money (exact cents, shared with the vending machine)
+ * - currency_profile.h      → Denomination + currency profiles/registry
+ * - cash_inventory.h        → lock-free CashInventory
+ * - payout_plan.h          → PayoutPlan (notes an exchange dispenses)
+ * - change_maker.h          → change-making strategies
+ * - transaction_journal.h   → mmap-backed crash-recovery journal
+ * - machine_telemetry.h     → counters + latency histogram
+ * - machine_snapshot.h      → binary snapshot/restore of one machine
+ * - refill_planner.h        → outflow forecast + refill recommendations
+ * - cash_exchange_machine.h → states + CashExchangeMachine
+ * - static_cash_exchange_machine.h → note set fixed at compile time
+ * - exchange_protocol.h     → binary wire format (exchange_server/client)
  *
- * OOP Concept:
- * - Encapsulation → Internal map is private
- * - Responsibility separation (SRP)
- */
-class CashInventory {
-private:
-
-    /// Encapsulated internal storage (STL container)
-    std::map<int, int> storage_;
-
-public:
-
-    /**
-     * @brief Constructor
-     *
-     * Initializes machine with default money.
-     */
-    CashInventory() {
-        storage_[5] = 20;
-        storage_[10] = 20;
-        storage_[20] = 20;
-        storage_[50] = 10;
-        storage_[100] = 5;
-    }
-
-    /**
-     * @brief Checks availability.
-     * @param value denomination
-     * @return true if available
-     *
-     * OOP Concept: Const correctness
-     */
-    bool hasDenomination(int value) const {
-        return storage_.count(value) && storage_.at(value) > 0;
-    }
-
-    /**
-     * @brief Add money to inventory.
-     */
-    void add(int value) {
-        storage_[value]++;
-    }
-
-    /**
-     * @brief Remove money from inventory.
-     *
-     * Demonstrates exception handling.
-     */
-    void remove(int value) {
-        if (!hasDenomination(value))
-            throw std::runtime_error("Denomination unavailable.");
-        storage_[value]--;
-    }
-
-    /**
-     * @brief Getter for inspection.
-     */
-    const std::map<int,int>& data() const {
-        return storage_;
-    }
-};
-
-/* ============================================================
-   FORWARD DECLARATION
-   Needed because states reference the machine.
-   ============================================================ */
-class CashExchangeMachine;
-
-/* ============================================================
-   CONTEXT CLASS
-   OOP Concepts:
-   - Composition (owns inventory)
-   - State Pattern
-   - Smart Pointer ownership
-   ============================================================ */
-
-/**
- * @class CashExchangeMachine
- * @brief Context of State Pattern.
+ * @usage
+ * g++ -std=c++17 cash_exchange.cpp -o machine
+ * ./machine [currencies.cfg]
  *
- * OOP Concept:
- * - Composition → owns CashInventory
- * - Aggregation → interacts with states
- * - RAII → unique_ptr manages state memory
+ * With a config file, one extra machine per loaded currency profile
+ * runs a short exchange after the EUR demo.
+ *
+ * or build every program of this folder with CMake:
+ * cmake -S . -B build && cmake --build build
  */
-class CashExchangeMachine {
-
-private:
-
-    int insertedAmount_{0};   ///< Encapsulated data member
-
-    CashInventory inventory_; ///< Composition
-
-    /**
-     * Smart pointer for state ownership.
-     *
-     * OOP Concept:
-     * - RAII
-     * - Unique ownership semantics
-     */
-    std::unique_ptr<IMachineState> state_;
-
-public:
-
-    /**
-     * @brief Constructor
-     */
-    CashExchangeMachine();
-
-    /**
-     * @brief Change state (State Pattern core).
-     */
-    void setState(std::unique_ptr<IMachineState> newState) {
-        state_ = std::move(newState);
-    }
-
-    /**
-     * @brief Delegate insert to current state.
-     *
-     * OOP Concept:
-     * - Polymorphism
-     */
-    void insertMoney(int amount) {
-        state_->insertMoney(amount);
-    }
-
-    /**
-     * @brief Delegate exchange to current state.
-     */
-    void exchange() {
-        state_->exchange();
-    }
-
-    void addInserted(int amount) {
-        insertedAmount_ += amount;
-    }
 
-    int getInserted() const {
-        return insertedAmount_;
-    }
-
-    void resetInserted() {
-        insertedAmount_ = 0;
-    }
-
-    CashInventory& inventory() {
-        return inventory_;
-    }
-
-    void printInventory() const {
-        std::cout << "\nInventory:\n";
-        for (const auto& [denom, count] : inventory_.data()) {
-            std::cout << denom << " EUR : " << count << "\n";
-        }
-    }
-
-    void printState() const {
-        std::cout << "[State: " << state_->name() << "] "
-                  << "[Inserted: " << insertedAmount_ << " EUR]\n";
-    }
-};
-
-/* Forward-declared state classes - fully defined after constructor */
-
-class IdleState : public IMachineState {
-
-private:
-    CashExchangeMachine& machine_;
-
-public:
-
-    explicit IdleState(CashExchangeMachine& m)
-        : machine_(m) {}
-
-    void insertMoney(int amount) override;
-    void exchange() override;
-    const char* name() const override { return "IdleState"; }
-};
-
-class HasMoneyState : public IMachineState {
-
-private:
-    CashExchangeMachine& machine_;
-
-public:
-
-    explicit HasMoneyState(CashExchangeMachine& m)
-        : machine_(m) {}
-
-    void insertMoney(int amount) override;
-    void exchange() override;
-    const char* name() const override { return "HasMoneyState"; }
-};
-
-/* ============================================================
-   CONTEXT CONSTRUCTOR IMPLEMENTATION
-   ============================================================ */
-
-CashExchangeMachine::CashExchangeMachine() {
-    state_ = std::make_unique<IdleState>(*this);
-}
-
-/* ============================================================
-   STATE METHOD IMPLEMENTATIONS
-   (Now that both classes are fully defined)
-   ============================================================ */
-
-void IdleState::insertMoney(int amount) {
-
-    if (amount != 5 && amount != 10 &&
-        amount != 20 && amount != 50 &&
-        amount != 100)
-        throw std::invalid_argument("Invalid denomination.");
-
-    // Validate max insert limit
-    if (machine_.getInserted() + amount > 500)
-        throw std::invalid_argument("Insert limit exceeded (max 500 EUR).");
+#include "cash_exchange_machine.h"
 
-    machine_.addInserted(amount);
-    machine_.inventory().add(amount);
-
-    // State transition
-    machine_.setState(std::make_unique<HasMoneyState>(machine_));
-}
-
-void IdleState::exchange() {
-    std::cout << "Insert money first.\n";
-}
-
-void HasMoneyState::insertMoney(int amount) {
-    if (amount != 5 && amount != 10 &&
-        amount != 20 && amount != 50 &&
-        amount != 100)
-        throw std::invalid_argument("Invalid denomination.");
-
-    // Validate max insert limit
-    if (machine_.getInserted() + amount > 500)
-        throw std::invalid_argument("Insert limit exceeded (max 500 EUR).");
-
-    machine_.addInserted(amount);
-    machine_.inventory().add(amount);
-}
-
-void HasMoneyState::exchange() {
-
-    int amount = machine_.getInserted();
-    int remaining = amount;
-
-    std::vector<int> denoms = {50, 20, 10, 5};
-
-    std::cout << "\nExchanging " << amount << " EUR:\n";
-
-    for (int d : denoms) {
-        while (remaining >= d &&
-               machine_.inventory().hasDenomination(d)) {
-            machine_.inventory().remove(d);
-            remaining -= d;
-            std::cout << "Dispensed: " << d << " EUR\n";
-        }
-    }
-
-    if (remaining > 0) {
-        std::cerr << "ERROR: Could not fully exchange. "
-                  << remaining << " EUR remaining (insufficient denominations).\n";
-        throw std::runtime_error("Partial exchange - denominations unavailable.");
-    }
-
-    std::cout << "Exchange completed successfully.\n";
-    machine_.resetInserted();
-
-    // Transition back to Idle
-    machine_.setState(std::make_unique<IdleState>(machine_));
-}
+#include <iostream>
 
 /* ============================================================
    MAIN FUNCTION
    ============================================================ */
 
-int main() {
+int main(int argc, char* argv[]) {
 
-    try {
+    CashExchangeMachine machine;
 
-        CashExchangeMachine machine;
+    try {
 
         std::cout << "=== Cash Exchange Machine ===";
         machine.printState();
         machine.printInventory();
 
+        std::cout << "\n--- Exchange with nothing inserted ---\n";
+        if (machine.tryExchange().status == MachineStatus::NothingInserted)
+            std::cout << "Insert money first.\n";
+
         std::cout << "\n--- Insert 100 EUR ---\n";
         machine.insertMoney(100);
         machine.printState();
         machine.exchange();
+        machine.printLastPayout();
         machine.printState();
         machine.printInventory();
 
@@ -402,6 +90,7 @@ int main() {
         machine.insertMoney(10);
         machine.printState();
         machine.exchange();
+        machine.printLastPayout();
         machine.printState();
         machine.printInventory();
 
@@ -419,5 +108,31 @@ int main() {
         std::cerr << "[EXCEPTION] " << e.what() << "\n";
     }
 
+    // Counters collected silently during the run
+    machine.printTelemetry();
+
+    if (argc > 1) {
+        try {
+            CurrencyRegistry currencies;
+            currencies.loadFile(argv[1]);
+
+            // Several currencies served side by side, one profile each
+            for (const CurrencyProfile& profile : currencies) {
+                CashExchangeMachine profileMachine(profile);
+
+                std::cout << "\n=== " << profile.code() << " machine ===\n";
+                profileMachine.insertMoney(20);
+                profileMachine.insertMoney(2);
+                profileMachine.printState();
+                profileMachine.exchange();
+                profileMachine.printLastPayout();
+                profileMachine.printInventory();
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[EXCEPTION] " << e.what() << "\n";
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,748 @@
+/**
+ * @file cash_exchange_machine.h
+ * @brief Cash exchange machine context and its states (State Pattern).
+ */
+#pragma once
+
+#include "../common/money.h"
+#include "cash_inventory.h"
+#include "change_maker.h"
+#include "machine_telemetry.h"
+#include "payout_plan.h"
+#include "transaction_journal.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* ============================================================
+   RESULT TYPES
+   Exception-free outcome of an event
+   ============================================================ */
+
+/**
+ * @brief Outcome of an insert or exchange event.
+ */
+enum class MachineStatus : std::uint8_t {
+    Ok,
+    InvalidDenomination,   ///< not a note/coin of the profile
+    LimitExceeded,         ///< insert would pass the profile limit
+    PartialExchange,       ///< no valid payout; inserted amount kept
+    NothingInserted,       ///< exchange while idle; nothing dispensed
+    JournalFailed          ///< event took effect, but its journal write failed
+};
+
+inline const char* toString(MachineStatus status) {
+    switch (status) {
+    case MachineStatus::Ok:                  return "Ok";
+    case MachineStatus::InvalidDenomination: return "InvalidDenomination";
+    case MachineStatus::LimitExceeded:       return "LimitExceeded";
+    case MachineStatus::PartialExchange:     return "PartialExchange";
+    case MachineStatus::NothingInserted:     return "NothingInserted";
+    case MachineStatus::JournalFailed:       return "JournalFailed";
+    }
+    return "Unknown";
+}
+
+/**
+ * @struct InsertResult
+ * @brief Status plus the amount inserted after the event.
+ */
+struct InsertResult {
+    MachineStatus status;
+    Money inserted;
+
+    bool ok() const { return status == MachineStatus::Ok; }
+};
+
+/**
+ * @struct ExchangeResult
+ * @brief Status plus the notes dispensed (empty unless dispensed()).
+ *
+ * Also the result of a cancel: then the notes handed back.
+ */
+struct ExchangeResult {
+    MachineStatus status;
+    const PayoutPlan& payout;
+
+    bool ok() const { return status == MachineStatus::Ok; }
+
+    /// Notes left the pool (the journal may still have failed)
+    bool dispensed() const {
+        return ok() || status == MachineStatus::JournalFailed;
+    }
+};
+
+/* ============================================================
+   INTERFACE (ABSTRACTION)
+   OOP Concept Applied: Abstraction + Polymorphism
+   ============================================================ */
+
+/**
+ * @class IMachineState
+ * @brief Pure abstract base class (Interface).
+ *
+ * OOP Concept:
+ * - Abstraction → Defines WHAT to do, not HOW
+ * - Polymorphism → Derived classes override behavior
+ */
+class IMachineState {
+public:
+
+    /**
+     * @brief Virtual destructor.
+     * Required for polymorphic base classes.
+     */
+    virtual ~IMachineState() = default;
+
+    /**
+     * @brief Insert money event (one note or coin).
+     *
+     * States report failures as a status; the machine decides
+     * whether to throw (insertMoney) or not (tryInsertMoney).
+     */
+    virtual MachineStatus insertMoney(Money amount) = 0;
+
+    /**
+     * @brief Exchange event.
+     */
+    virtual MachineStatus exchange() = 0;
+
+    /**
+     * @brief Cancel event: hand the inserted notes back.
+     */
+    virtual MachineStatus cancel() = 0;
+
+    /**
+     * @brief Returns state name.
+     */
+    virtual const char* name() const = 0;
+};
+
+/* ============================================================
+   FORWARD DECLARATION
+   Needed because states reference the machine.
+   ============================================================ */
+class CashExchangeMachine;
+
+/* ============================================================
+   CONCRETE STATES
+   OOP Concept Applied: Inheritance + Polymorphism
+   ============================================================ */
+
+class IdleState : public IMachineState {
+
+private:
+    CashExchangeMachine& machine_;
+
+public:
+
+    explicit IdleState(CashExchangeMachine& m)
+        : machine_(m) {}
+
+    MachineStatus insertMoney(Money amount) override;
+    MachineStatus exchange() override;
+    MachineStatus cancel() override;
+    const char* name() const override { return "IdleState"; }
+};
+
+class HasMoneyState : public IMachineState {
+
+private:
+    CashExchangeMachine& machine_;
+
+public:
+
+    explicit HasMoneyState(CashExchangeMachine& m)
+        : machine_(m) {}
+
+    MachineStatus insertMoney(Money amount) override;
+    MachineStatus exchange() override;
+    MachineStatus cancel() override;
+    const char* name() const override { return "HasMoneyState"; }
+};
+
+/* ============================================================
+   CONTEXT CLASS
+   OOP Concepts:
+   - Composition (owns inventory and both states)
+   - State Pattern
+   - Smart Pointer ownership
+   ============================================================ */
+
+/**
+ * @class CashExchangeMachine
+ * @brief Context of State Pattern.
+ *
+ * OOP Concept:
+ * - Composition → owns one instance of each state
+ * - Aggregation → interacts with states, may share its CashInventory
+ * - RAII → smart pointers manage inventory and change-making strategy
+ *
+ * States are stateless apart from the back-reference to the machine,
+ * so each one is built once with the machine and a transition only
+ * repoints state_. Insert/exchange events never allocate.
+ *
+ * Multi-terminal mode: several machines constructed from the same
+ * std::shared_ptr<CashInventory> draw from one cash pool. Each machine
+ * (terminal) is driven by one thread at a time; the shared inventory
+ * itself is lock-free and never goes negative.
+ */
+class CashExchangeMachine {
+
+private:
+
+    Money insertedAmount_;    ///< Encapsulated data member (exact cents)
+
+    /// Notes of the current transaction per profile slot (for a refund)
+    std::array<int, kMaxDenominations> insertedNotes_{};
+
+    /// Cash pool, private or shared with other terminals
+    std::shared_ptr<CashInventory> inventory_;
+
+    IdleState idleState_{*this};          ///< Preallocated Idle state
+    HasMoneyState hasMoneyState_{*this};  ///< Preallocated HasMoney state
+
+    /// Current state, always one of the members above
+    IMachineState* state_{&idleState_};
+
+    /// Strategy used to compute payouts (Strategy Pattern)
+    std::unique_ptr<IChangeMaker> changeMaker_;
+
+    /// Reused payout plan of the current/last exchange
+    PayoutPlan payout_{kMaxDenominations};
+
+    /// Counters and latency histogram (printed only on request)
+    MachineTelemetry telemetry_;
+
+    /// Optional crash-recovery journal (not owned)
+    TransactionJournal* journal_{nullptr};
+
+    /**
+     * @brief Snapshot the journal once its record area is full.
+     */
+    void checkpoint() {
+        if (journal_->needsSnapshot())
+            journal_->snapshot(*inventory_, insertedNotes_);
+    }
+
+    /**
+     * @brief Append one event and checkpoint; journal errors become a status.
+     *
+     * The event has already changed the machine, so an I/O error must
+     * not unwind through a state half-way into its transition.
+     */
+    template <class Append>
+    MachineStatus journaled(Append append) {
+        if (!journal_)
+            return MachineStatus::Ok;
+        try {
+            append(*journal_);
+            checkpoint();
+        } catch (const std::exception&) {
+            return MachineStatus::JournalFailed;
+        }
+        return MachineStatus::Ok;
+    }
+
+public:
+
+    /// Attempts to re-plan a payout that lost a race for notes
+    static constexpr int kMaxPayoutAttempts = 4;
+
+    /// No note is worth more than this many units
+    static constexpr Money::Rep kMaxNoteValue = 1'000'000;
+
+    /**
+     * @brief Constructor - machine with its own cash.
+     * @param profile currency served by this machine
+     */
+    explicit CashExchangeMachine(const CurrencyProfile& profile = CurrencyProfile::eur());
+
+    /**
+     * @brief Constructor - terminal drawing from a shared cash pool.
+     */
+    explicit CashExchangeMachine(std::shared_ptr<CashInventory> pool);
+
+    /// States keep a reference to this machine - no copies or moves
+    CashExchangeMachine(const CashExchangeMachine&) = delete;
+    CashExchangeMachine& operator=(const CashExchangeMachine&) = delete;
+
+    /**
+     * @brief Change state (State Pattern core).
+     */
+    void setState(IMachineState& newState) {
+        state_ = &newState;
+    }
+
+    IdleState& idleState() {
+        return idleState_;
+    }
+
+    HasMoneyState& hasMoneyState() {
+        return hasMoneyState_;
+    }
+
+    /**
+     * @brief Delegate insert to current state.
+     * @throws std::invalid_argument for a rejected note
+     * @throws std::runtime_error if the journal write failed (note accepted)
+     *
+     * OOP Concept:
+     * - Polymorphism
+     */
+    void insertMoney(Money amount) {
+        raise(state_->insertMoney(amount));
+    }
+
+    /**
+     * @brief Insert one note given in whole currency units.
+     */
+    void insertMoney(int note) {
+        insertMoney(Money::fromUnits(note));
+    }
+
+    /**
+     * @brief Delegate exchange to current state.
+     * @throws std::runtime_error on a partial exchange, or if the
+     *         journal write failed (then the notes were paid out)
+     *
+     * An exchange with nothing inserted is a no-op, not an error;
+     * tryExchange() reports it as NothingInserted.
+     */
+    void exchange() {
+        raise(state_->exchange());
+    }
+
+    /**
+     * @brief Cancel the transaction: the inserted notes come back.
+     * @throws std::runtime_error if the pool cannot pay the amount back
+     */
+    void cancel() {
+        raise(state_->cancel());
+    }
+
+    /**
+     * @brief Exception-free insert: same states, status instead of throw.
+     *
+     * Never throws, journal I/O errors included: a note accepted in
+     * memory whose record did not reach the journal is JournalFailed.
+     */
+    InsertResult tryInsertMoney(Money amount) {
+        return {state_->insertMoney(amount), insertedAmount_};
+    }
+
+    InsertResult tryInsertMoney(int note) {
+        return tryInsertMoney(Money::fromUnits(note));
+    }
+
+    /**
+     * @brief Exception-free exchange; the payout is valid until the next one.
+     *
+     * JournalFailed means the notes were paid out (dispensed()) but the
+     * exchange record did not reach the journal.
+     */
+    ExchangeResult tryExchange() {
+        return {state_->exchange(), payout_};
+    }
+
+    /**
+     * @brief Exception-free cancel; the payout holds the notes returned.
+     *
+     * The customer's own notes are returned if they are still in the
+     * pool; on a shared pool that paid some of them out meanwhile, the
+     * same value in other notes. If neither is possible the status is
+     * PartialExchange and the machine keeps waiting (HasMoney).
+     */
+    ExchangeResult tryCancel() {
+        return {state_->cancel(), payout_};
+    }
+
+    /**
+     * @brief Turn a failure status into the exception of the throwing API.
+     */
+    void raise(MachineStatus status) const {
+        switch (status) {
+        case MachineStatus::Ok:
+            return;
+        case MachineStatus::InvalidDenomination:
+            throw std::invalid_argument("Invalid denomination.");
+        case MachineStatus::LimitExceeded:
+            throw std::invalid_argument("Insert limit exceeded (max " +
+                                        std::to_string(profile().limit()) + " " +
+                                        profile().code() + ").");
+        case MachineStatus::PartialExchange:
+            throw std::runtime_error("Partial exchange - denominations unavailable.");
+        case MachineStatus::NothingInserted:
+            return;
+        case MachineStatus::JournalFailed:
+            throw std::runtime_error("Journal write failed - event not durable.");
+        }
+    }
+
+    /**
+     * @brief Credit one accepted note to the current transaction.
+     */
+    void addInserted(int note) {
+        const int slot = profile().slotOf(note);
+        if (slot < 0)
+            return;   // validateInsert() let it through, so never here
+        insertedAmount_ += Money::fromUnits(note);
+        ++insertedNotes_[static_cast<std::size_t>(slot)];
+    }
+
+    Money getInserted() const {
+        return insertedAmount_;
+    }
+
+    /**
+     * @brief Notes of the current transaction, per profile slot.
+     */
+    const std::array<int, kMaxDenominations>& insertedNotes() const {
+        return insertedNotes_;
+    }
+
+    void resetInserted() {
+        insertedAmount_ = Money();
+        insertedNotes_.fill(0);
+    }
+
+    /**
+     * @brief Restore the open transaction (journal / snapshot recovery).
+     *
+     * The inserted amount follows from the notes; the state is
+     * HasMoney exactly when there are any.
+     */
+    void restoreInserted(const std::array<int, kMaxDenominations>& notes) {
+        insertedNotes_ = notes;
+        insertedAmount_ = Money();
+        for (std::size_t i = 0; i < profile().size(); ++i)
+            insertedAmount_ += Money::fromUnits(profile().value(i)) * notes[i];
+        state_ = insertedAmount_ > Money() ? static_cast<IMachineState*>(&hasMoneyState_)
+                                           : &idleState_;
+    }
+
+    CashInventory& inventory() {
+        return *inventory_;
+    }
+
+    const CashInventory& inventory() const {
+        return *inventory_;
+    }
+
+    /**
+     * @brief Waiting for more notes or an exchange (HasMoneyState).
+     */
+    bool hasMoney() const {
+        return state_ == &hasMoneyState_;
+    }
+
+    /**
+     * @brief Currency tables of this machine (bound at construction).
+     */
+    const CurrencyProfile& profile() const {
+        return inventory_->profile();
+    }
+
+    /**
+     * @brief Replace the change-making strategy.
+     */
+    void setChangeMaker(std::unique_ptr<IChangeMaker> changeMaker) {
+        changeMaker_ = std::move(changeMaker);
+    }
+
+    IChangeMaker& changeMaker() {
+        return *changeMaker_;
+    }
+
+    PayoutPlan& payout() {
+        return payout_;
+    }
+
+    /**
+     * @brief Notes dispensed by the last exchange (empty if it failed).
+     */
+    const PayoutPlan& lastPayout() const {
+        return payout_;
+    }
+
+    /**
+     * @brief Reject unknown denominations and inserts over the limit.
+     * @param[out] note the note value in whole units (only set if Ok)
+     *
+     * One table lookup in the machine's currency profile.
+     */
+    MachineStatus validateInsert(Money amount, int& note) {
+        const CurrencyProfile& p = profile();
+        const Money::Rep units = amount.units();
+        if (!amount.isWhole() || units <= 0 || units > kMaxNoteValue ||
+            !p.accepts(static_cast<int>(units))) {
+            telemetry_.recordInvalidInsert();
+            return MachineStatus::InvalidDenomination;
+        }
+
+        // Validate max insert limit
+        if (insertedAmount_ + amount > Money::fromUnits(p.limit())) {
+            telemetry_.recordLimitInsert();
+            return MachineStatus::LimitExceeded;
+        }
+
+        note = static_cast<int>(units);
+        return MachineStatus::Ok;
+    }
+
+    /**
+     * @brief Refill notes of one denomination.
+     */
+    void refill(int value, int count) {
+        // Check what the journal can hold before the inventory changes
+        if (journal_ && count > TransactionJournal::kMaxNotesPerRecord)
+            throw std::length_error("Refill too large for one journal record.");
+        inventory_->refill(value, count);
+        if (journal_) {
+            journal_->appendRefill(profile(), value, count);
+            checkpoint();
+        }
+    }
+
+    /**
+     * @brief Recover state from a journal and log every event to it.
+     *
+     * If the journal already holds history, the inventory counts,
+     * inserted amount and state are rebuilt from it; a fresh journal
+     * starts with a snapshot of the current state. Meant for a machine
+     * that owns its inventory (one writer per journal).
+     *
+     * @throws std::invalid_argument if a payout of this profile could
+     *         not be journaled in one record
+     */
+    void attachJournal(TransactionJournal& journal) {
+        if (!TransactionJournal::supports(profile()))
+            throw std::invalid_argument("Currency profile too large for the journal.");
+
+        TransactionJournal::State recovered;
+        if (journal.recover(profile(), recovered)) {
+            for (std::size_t i = 0; i < profile().size(); ++i)
+                inventory_->setCount(profile().value(i), recovered.counts[i]);
+            restoreInserted(recovered.inserted);
+        } else {
+            journal.snapshot(*inventory_, insertedNotes_);
+        }
+        journal_ = &journal;
+
+        // A crash right after the last record fit leaves a full log
+        checkpoint();
+    }
+
+    /**
+     * @brief Telemetry/journal hooks called by the states after an event.
+     * @return JournalFailed if the event could not be journaled
+     */
+    MachineStatus recordInsert(int amount) {
+        telemetry_.recordInsert(profile().slotOf(amount));
+        return journaled([&](TransactionJournal& j) {
+            j.appendInsert(profile(), amount);
+        });
+    }
+
+    MachineStatus recordExchange(int amount, const PayoutPlan& plan, std::uint64_t ns) {
+        telemetry_.recordExchange(profile(), plan, ns);
+        return journaled([&](TransactionJournal& j) {
+            j.appendExchange(profile(), amount, plan);
+        });
+    }
+
+    MachineStatus recordRefund(int amount, const PayoutPlan& plan) {
+        telemetry_.recordRefund(profile(), plan);
+        return journaled([&](TransactionJournal& j) {
+            j.appendRefund(profile(), amount, plan);
+        });
+    }
+
+    void recordPartialExchange(std::uint64_t ns) {
+        telemetry_.recordPartialExchange(ns);
+    }
+
+    void recordIdleExchange() {
+        telemetry_.recordIdleExchange();
+    }
+
+    const MachineTelemetry& telemetry() const {
+        return telemetry_;
+    }
+
+    /**
+     * @brief Human-readable views - formatting happens only here.
+     */
+    void printLastPayout() const {
+        std::cout << "\nDispensed:\n";
+        for (const PayoutEntry& e : payout_)
+            std::cout << e.count << " x " << e.denomination << " " << profile().code() << "\n";
+    }
+
+    void printTelemetry() const {
+        telemetry_.print(std::cout, profile());
+    }
+
+    void printInventory() const {
+        std::cout << "\nInventory:\n";
+        for (const auto& [denom, count] : inventory_->data()) {
+            std::cout << denom << " " << profile().code() << " : " << count << "\n";
+        }
+    }
+
+    void printState() const {
+        std::cout << "[State: " << state_->name() << "] "
+                  << "[Inserted: " << insertedAmount_ << " " << profile().code() << "]\n";
+    }
+};
+
+/* ============================================================
+   CONTEXT CONSTRUCTOR IMPLEMENTATION
+   ============================================================ */
+
+inline CashExchangeMachine::CashExchangeMachine(const CurrencyProfile& profile)
+    : CashExchangeMachine(std::make_shared<CashInventory>(profile)) {}
+
+inline CashExchangeMachine::CashExchangeMachine(std::shared_ptr<CashInventory> pool)
+    : inventory_(std::move(pool)) {
+    // Every amount the insert limit allows, answered from a table
+    int step = 0;
+    for (std::size_t i = 0; i < profile().size(); ++i)
+        step = std::gcd(step, profile().value(i));
+
+    auto cached = std::make_unique<CachedChangeMaker>(
+        std::make_unique<OptimalChangeMaker>(profile().payoutDenominations()),
+        profile().limit(), step);
+    cached->precompute(*inventory_, payout_);
+    setChangeMaker(std::move(cached));
+}
+
+/* ============================================================
+   STATE METHOD IMPLEMENTATIONS
+   (Now that the machine is fully defined)
+   ============================================================ */
+
+inline MachineStatus IdleState::insertMoney(Money amount) {
+
+    int note = 0;
+    MachineStatus status = machine_.validateInsert(amount, note);
+    if (status != MachineStatus::Ok)
+        return status;
+
+    machine_.addInserted(note);
+    machine_.inventory().add(note);
+    const MachineStatus logged = machine_.recordInsert(note);
+
+    // State transition
+    machine_.setState(machine_.hasMoneyState());
+    return logged;
+}
+
+inline MachineStatus IdleState::exchange() {
+    // Nothing inserted - nothing dispensed, just count it
+    machine_.payout().clear();
+    machine_.recordIdleExchange();
+    return MachineStatus::NothingInserted;
+}
+
+inline MachineStatus IdleState::cancel() {
+    machine_.payout().clear();
+    return MachineStatus::NothingInserted;
+}
+
+inline MachineStatus HasMoneyState::insertMoney(Money amount) {
+    int note = 0;
+    MachineStatus status = machine_.validateInsert(amount, note);
+    if (status != MachineStatus::Ok)
+        return status;
+
+    machine_.addInserted(note);
+    machine_.inventory().add(note);
+    return machine_.recordInsert(note);
+}
+
+inline MachineStatus HasMoneyState::exchange() {
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    // Notes are whole units, so the payout is planned in units
+    int amount = static_cast<int>(machine_.getInserted().units());
+
+    PayoutPlan& plan = machine_.payout();
+    CashInventory& inventory = machine_.inventory();
+
+    // Plan the whole payout first, then commit it in a single step.
+    // A shared pool can change between the two, so a lost race is
+    // re-planned against the new counts a few times.
+    bool paid = false;
+    for (int attempt = 0;
+         !paid && attempt < CashExchangeMachine::kMaxPayoutAttempts;
+         ++attempt) {
+        if (!machine_.changeMaker().makeChange(amount, inventory, plan))
+            break;
+        paid = inventory.tryApply(plan);
+    }
+
+    const std::uint64_t ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+    // Inventory is untouched on failure
+    if (!paid) {
+        plan.clear();
+        machine_.recordPartialExchange(ns);
+        return MachineStatus::PartialExchange;
+    }
+
+    machine_.resetInserted();
+    const MachineStatus logged = machine_.recordExchange(amount, plan, ns);
+
+    // Transition back to Idle
+    machine_.setState(machine_.idleState());
+    return logged;
+}
+
+inline MachineStatus HasMoneyState::cancel() {
+
+    const int amount = static_cast<int>(machine_.getInserted().units());
+    const CurrencyProfile& profile = machine_.profile();
+
+    PayoutPlan& plan = machine_.payout();
+    CashInventory& inventory = machine_.inventory();
+
+    // The customer's own notes first
+    plan.clear();
+    const std::array<int, kMaxDenominations>& notes = machine_.insertedNotes();
+    for (std::size_t i = 0; i < profile.size(); ++i)
+        plan.add(profile.value(i), notes[i]);
+    bool paid = inventory.tryApply(plan);
+
+    // Another terminal of a shared pool paid some of them out: the
+    // same value in other notes, planned like an exchange
+    for (int attempt = 0;
+         !paid && attempt < CashExchangeMachine::kMaxPayoutAttempts;
+         ++attempt) {
+        if (!machine_.changeMaker().makeChange(amount, inventory, plan))
+            break;
+        paid = inventory.tryApply(plan);
+    }
+
+    if (!paid) {
+        plan.clear();
+        return MachineStatus::PartialExchange;
+    }
+
+    machine_.resetInserted();
+    const MachineStatus logged = machine_.recordRefund(amount, plan);
+
+    // Transition back to Idle
+    machine_.setState(machine_.idleState());
+    return logged;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file cash_inventory.h
+ * @brief Denominations and note storage of the cash exchange machine.
+ */
+#pragma once
+
+#include "currency_profile.h"
+#include "payout_plan.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+/* ============================================================
+   CASH INVENTORY
+   OOP Concept Applied: Encapsulation
+   ============================================================ */
+
+/**
+ * @class CashInventory
+ * @brief Manages machine cash storage.
+ *
+ * OOP Concept:
+ * - Encapsulation → Internal counters are private
+ * - Responsibility separation (SRP)
+ *
+ * One counter per denomination slot in a std::array, so every
+ * lookup is an index into a flat array. Slots follow the inventory's
+ * CurrencyProfile, bound at construction.
+ *
+ * Counters are lock-free atomics, each on its own cache line, so one
+ * inventory can be shared by several terminals running on different
+ * threads. Removals reserve notes with compare-and-swap and never
+ * take a counter below zero; a plan that cannot be reserved in full
+ * is rolled back.
+ */
+class CashInventory {
+private:
+
+    /**
+     * @struct Slot
+     * @brief One counter, padded to a cache line (no false sharing).
+     */
+    struct alignas(64) Slot {
+        std::atomic<int> count{0};
+    };
+
+    /// Currency tables (value → slot), shared and immutable
+    const CurrencyProfile* profile_;
+
+    /// Encapsulated internal storage, indexed by profile slot
+    std::array<Slot, kMaxDenominations> storage_{};
+
+    /**
+     * @brief Take `n` notes from a slot unless fewer are left.
+     */
+    bool reserve(int slot, int n) {
+        std::atomic<int>& counter = storage_[slot].count;
+        int current = counter.load(std::memory_order_relaxed);
+        do {
+            if (current < n)
+                return false;
+        } while (!counter.compare_exchange_weak(current, current - n,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+        return true;
+    }
+
+public:
+
+    /**
+     * @class View
+     * @brief Read-only range of (denomination, count) pairs.
+     *
+     * Iterates in ascending denomination order, exactly like the
+     * std::map it replaces.
+     */
+    class View {
+    public:
+
+        class iterator {
+        public:
+            iterator(const CashInventory* inventory, std::size_t slot)
+                : inventory_(inventory), slot_(slot) {}
+
+            std::pair<int, int> operator*() const {
+                return {inventory_->profile_->value(slot_),
+                        inventory_->countAt(slot_)};
+            }
+
+            iterator& operator++() {
+                ++slot_;
+                return *this;
+            }
+
+            bool operator!=(const iterator& other) const {
+                return slot_ != other.slot_;
+            }
+
+        private:
+            const CashInventory* inventory_;
+            std::size_t slot_;
+        };
+
+        explicit View(const CashInventory* inventory) : inventory_(inventory) {}
+
+        iterator begin() const { return {inventory_, 0}; }
+        iterator end() const { return {inventory_, inventory_->profile_->size()}; }
+
+    private:
+        const CashInventory* inventory_;
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * Initializes machine with the profile's default money.
+     */
+    explicit CashInventory(const CurrencyProfile& profile = CurrencyProfile::eur())
+        : profile_(&profile) {
+        for (std::size_t i = 0; i < profile.size(); ++i)
+            storage_[i].count = profile.initialStock(i);
+    }
+
+    const CurrencyProfile& profile() const {
+        return *profile_;
+    }
+
+    /**
+     * @brief Number of notes in a slot (slot < profile().size()).
+     */
+    int countAt(std::size_t slot) const {
+        return storage_[slot].count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Checks availability.
+     * @param value denomination
+     * @return true if available
+     *
+     * OOP Concept: Const correctness
+     */
+    bool hasDenomination(int value) const {
+        return count(value) > 0;
+    }
+
+    /**
+     * @brief Number of notes stored for a denomination.
+     * @param value denomination
+     * @return note count (0 if unknown)
+     *
+     * Under concurrent use this is a snapshot; only remove()/apply()
+     * decide whether notes can really be taken.
+     */
+    int count(int value) const {
+        int slot = profile_->slotOf(value);
+        return slot >= 0 ? countAt(static_cast<std::size_t>(slot)) : 0;
+    }
+
+    /**
+     * @brief Add money to inventory.
+     */
+    void add(int value) {
+        int slot = profile_->slotOf(value);
+        if (slot < 0)
+            throw std::invalid_argument("Invalid denomination.");
+        storage_[slot].count.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Refill `count` notes of a denomination.
+     */
+    void refill(int value, int count) {
+        int slot = profile_->slotOf(value);
+        if (slot < 0 || count < 0)
+            throw std::invalid_argument("Invalid refill.");
+        storage_[slot].count.fetch_add(count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Overwrite the count of a denomination (state recovery).
+     */
+    void setCount(int value, int count) {
+        int slot = profile_->slotOf(value);
+        if (slot < 0 || count < 0)
+            throw std::invalid_argument("Invalid count.");
+        storage_[slot].count.store(count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Remove money from inventory.
+     *
+     * Demonstrates exception handling.
+     */
+    void remove(int value) {
+        int slot = profile_->slotOf(value);
+        if (slot < 0 || !reserve(slot, 1))
+            throw std::runtime_error("Denomination unavailable.");
+    }
+
+    /**
+     * @brief Checks that every entry of a plan is in stock.
+     */
+    bool canApply(const PayoutPlan& plan) const {
+        for (const PayoutEntry& e : plan) {
+            if (count(e.denomination) < e.count)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reserve every entry of a plan, all or nothing.
+     * @return false (inventory unchanged) if any denomination is short
+     *
+     * Entries are reserved one slot at a time; on a shortfall the
+     * slots already taken are handed back.
+     */
+    bool tryApply(const PayoutPlan& plan) {
+        for (std::size_t i = 0; i < plan.size(); ++i) {
+            int slot = profile_->slotOf(plan[i].denomination);
+            if (slot < 0 || !reserve(slot, plan[i].count)) {
+                while (i-- > 0)
+                    storage_[profile_->slotOf(plan[i].denomination)].count.fetch_add(
+                        plan[i].count, std::memory_order_release);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Commit a whole payout plan in one step.
+     *
+     * Either every entry is removed or, if any denomination is short,
+     * nothing is and std::runtime_error is thrown.
+     */
+    void apply(const PayoutPlan& plan) {
+        if (!tryApply(plan))
+            throw std::runtime_error("Denomination unavailable.");
+    }
+
+    /**
+     * @brief Getter for inspection.
+     */
+    View data() const {
+        return View(this);
+    }
+};
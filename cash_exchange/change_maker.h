@@ -0,0 +1,391 @@
+/**
+ * @file change_maker.h
+ * @brief Pluggable change-making strategies (greedy and bounded DP).
+ */
+#pragma once
+
+#include "cash_inventory.h"
+#include "payout_plan.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+/* ============================================================
+   CHANGE-MAKING ENGINE
+   OOP Concept Applied: Strategy Pattern + Polymorphism
+   ============================================================ */
+
+/**
+ * @class IChangeMaker
+ * @brief Interface of a change-making strategy.
+ *
+ * A strategy only READS the inventory and fills a PayoutPlan with
+ * the notes that should be dispensed. The machine decides what to
+ * do with the answer.
+ *
+ * Contract (relied on by CachedChangeMaker):
+ * - the answer depends on the count of denomination d only through
+ *   min(count, amount / d) - notes the amount can never use are moot
+ * - fewer notes never make an unpayable amount payable, and a payout
+ *   that is still covered by the counts stays an acceptable answer
+ */
+class IChangeMaker {
+public:
+
+    virtual ~IChangeMaker() = default;
+
+    /**
+     * @brief Computes a payout for the given amount.
+     * @param amount    amount to pay out
+     * @param inventory notes currently available
+     * @param[out] plan notes to dispense (only valid on success)
+     * @return true if the amount can be paid out exactly
+     */
+    virtual bool makeChange(int amount,
+                            const CashInventory& inventory,
+                            PayoutPlan& plan) = 0;
+
+    /**
+     * @brief Payout denominations, largest first.
+     */
+    virtual const std::vector<int>& denominations() const = 0;
+
+    /**
+     * @brief Returns strategy name.
+     */
+    virtual const char* name() const = 0;
+};
+
+/**
+ * @class GreedyChangeMaker
+ * @brief Largest-note-first payout bounded by the inventory counts.
+ *
+ * O(denominations) per payout, but may fail although a valid
+ * combination exists (e.g. 60 EUR with no 10/5 notes left).
+ */
+class GreedyChangeMaker : public IChangeMaker {
+
+protected:
+
+    std::vector<int> denoms_; ///< Payout denominations, descending
+
+public:
+
+    explicit GreedyChangeMaker(std::vector<int> denoms)
+        : denoms_(std::move(denoms)) {}
+
+    bool makeChange(int amount,
+                    const CashInventory& inventory,
+                    PayoutPlan& plan) override {
+        plan.clear();
+
+        int remaining = amount;
+        for (int d : denoms_) {
+            int take = std::min(inventory.count(d), remaining / d);
+            plan.add(d, take);
+            remaining -= take * d;
+        }
+        return remaining == 0;
+    }
+
+    const std::vector<int>& denominations() const override {
+        return denoms_;
+    }
+
+    const char* name() const override { return "Greedy"; }
+};
+
+/**
+ * @class OptimalChangeMaker
+ * @brief Bounded-knapsack payout with a greedy fast path.
+ *
+ * The greedy walk is tried first; only when it fails the DP runs.
+ * The DP finds the payout with the fewest notes that respects every
+ * per-denomination count. Amounts are scaled down by the gcd of the
+ * denominations, and each denomination is folded in with a sliding
+ * window minimum per residue class, so a payout costs
+ * O(denominations x amount / gcd).
+ *
+ * All tables live in member scratch buffers that only ever grow,
+ * so repeated payouts do not allocate.
+ */
+class OptimalChangeMaker : public GreedyChangeMaker {
+
+private:
+
+    static constexpr int kUnreachable = INT_MAX / 2;
+
+    int gcd_{1};                 ///< gcd of all payout denominations
+
+    std::vector<int> best_;      ///< fewest notes per scaled amount
+    std::vector<int> prev_;      ///< previous DP layer
+    std::vector<int> take_;      ///< notes taken per (denomination, amount)
+    std::vector<int> window_;    ///< sliding window of step indices
+    std::vector<int> counts_;    ///< recovered notes per denomination
+
+public:
+
+    explicit OptimalChangeMaker(std::vector<int> denoms)
+        : GreedyChangeMaker(std::move(denoms)) {
+        gcd_ = 0;
+        for (int d : denoms_)
+            gcd_ = std::gcd(gcd_, d);
+        if (gcd_ == 0)
+            gcd_ = 1;
+    }
+
+    bool makeChange(int amount,
+                    const CashInventory& inventory,
+                    PayoutPlan& plan) override {
+        // Fast path: greedy already succeeds for most payouts
+        if (GreedyChangeMaker::makeChange(amount, inventory, plan))
+            return true;
+
+        if (amount % gcd_ != 0)
+            return false;
+
+        return solve(amount / gcd_, inventory, plan);
+    }
+
+    const char* name() const override { return "Optimal"; }
+
+private:
+
+    /**
+     * @brief Bounded min-notes DP over the scaled amount.
+     *
+     * For a note of scaled value v with bound c, amount w = r + j*v
+     * is reached from r + k*v (j - c <= k <= j) with j - k notes, so
+     * best[w] = j + min(prev[r + k*v] - k) over that window. A
+     * monotone queue keeps the window minimum in O(1) amortized.
+     */
+    bool solve(int target,
+               const CashInventory& inventory,
+               PayoutPlan& plan) {
+        const std::size_t n = denoms_.size();
+        const std::size_t width = static_cast<std::size_t>(target) + 1;
+
+        best_.resize(width);
+        prev_.resize(width);
+        take_.resize(n * width);
+        window_.resize(width);
+
+        std::fill(best_.begin(), best_.end(), kUnreachable);
+        best_[0] = 0;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const int v = denoms_[i] / gcd_;
+            const int bound = std::min(inventory.count(denoms_[i]), target / v);
+            int* take = take_.data() + i * width;
+
+            prev_.swap(best_);
+
+            for (int r = 0; r < v && r <= target; ++r) {
+                int head = 0;
+                int tail = 0;
+
+                for (int j = 0; r + j * v <= target; ++j) {
+                    const int w = r + j * v;
+
+                    // Push step j, keeping keys (prev - step) increasing
+                    if (prev_[w] < kUnreachable) {
+                        while (tail > head &&
+                               prev_[r + window_[tail - 1] * v] - window_[tail - 1]
+                                   >= prev_[w] - j)
+                            --tail;
+                        window_[tail++] = j;
+                    }
+
+                    // Drop steps that would need more than `bound` notes
+                    while (tail > head && window_[head] < j - bound)
+                        ++head;
+
+                    if (tail > head) {
+                        const int k = window_[head];
+                        best_[w] = prev_[r + k * v] - k + j;
+                        take[w] = j - k;
+                    } else {
+                        best_[w] = kUnreachable;
+                        take[w] = 0;
+                    }
+                }
+            }
+        }
+
+        if (best_[target] >= kUnreachable)
+            return false;
+
+        // Walk the take table backwards to recover the note counts
+        counts_.resize(n);
+        int w = target;
+        for (std::size_t i = n; i-- > 0;) {
+            counts_[i] = take_[i * width + w];
+            w -= counts_[i] * (denoms_[i] / gcd_);
+        }
+
+        plan.clear();
+        for (std::size_t i = 0; i < n; ++i)
+            plan.add(denoms_[i], counts_[i]);
+        return true;
+    }
+};
+
+/* ============================================================
+   PAYOUT CACHE
+   OOP Concept Applied: Decorator Pattern
+   ============================================================ */
+
+/**
+ * @class CachedChangeMaker
+ * @brief Per-amount payout table in front of another strategy.
+ *
+ * The insert limit leaves only a few possible amounts (500 EUR in
+ * 5 EUR steps = 100 amounts), so the answer of the wrapped strategy
+ * is stored per amount together with the clamped counts it was
+ * computed from, min(count, amount / d) per denomination d.
+ *
+ * By the IChangeMaker contract an entry stays good while, for every d,
+ * - count >= notes of d in the cached payout (it can still be paid), and
+ * - min(count, amount / d) <= the clamped count seen (no new option
+ *   appeared that could give a better payout).
+ * Only a count crossing one of those thresholds forces a recompute,
+ * so a payout is mostly a table lookup plus two compares per
+ * denomination.
+ *
+ * Unpayable amounts are cached as well. Amounts above `maxAmount` or
+ * off the `step` grid bypass the table. Table cells are 16 bit (they
+ * never exceed maxAmount), about 2.5 KB for the EUR profile.
+ */
+class CachedChangeMaker : public IChangeMaker {
+
+private:
+
+    enum : std::uint8_t { kUnknown, kPayable, kUnpayable };
+
+    using Cell = std::int16_t;
+
+    std::unique_ptr<IChangeMaker> inner_;
+    std::size_t n_;                    ///< payout denominations
+    int maxAmount_;
+    int step_;                         ///< amounts cached: 0, step, 2*step, ...
+
+    // One row of n_ cells per cached amount (structure of arrays)
+    std::vector<std::uint8_t> status_; ///< kUnknown / kPayable / kUnpayable
+    std::vector<Cell> notes_;          ///< notes per denomination (lower bound)
+    std::vector<Cell> need_;           ///< amount / d - larger counts never matter
+    std::vector<Cell> seen_;           ///< min(count, need) when computed (upper bound)
+
+    long hits_{0};
+    long misses_{0};
+
+    /**
+     * @brief Every count still lies between the bounds of the row.
+     */
+    bool fresh(std::size_t row, const CashInventory& inventory) const {
+        const std::vector<int>& denoms = inner_->denominations();
+        const Cell* notes = notes_.data() + row;
+        const Cell* need = need_.data() + row;
+        const Cell* seen = seen_.data() + row;
+        for (std::size_t i = 0; i < n_; ++i) {
+            const int count = inventory.count(denoms[i]);
+            if (count < notes[i] || std::min(count, int{need[i]}) > seen[i])
+                return false;
+        }
+        return true;
+    }
+
+    void store(std::size_t row, bool ok,
+               const CashInventory& inventory,
+               const PayoutPlan& plan) {
+        const std::vector<int>& denoms = inner_->denominations();
+        for (std::size_t i = 0; i < n_; ++i) {
+            seen_[row + i] = static_cast<Cell>(
+                std::min(inventory.count(denoms[i]), int{need_[row + i]}));
+            notes_[row + i] = 0;
+        }
+        if (ok) {
+            // The plan may skip or reorder denominations - map it back
+            for (const PayoutEntry& e : plan) {
+                for (std::size_t i = 0; i < n_; ++i) {
+                    if (denoms[i] == e.denomination)
+                        notes_[row + i] = static_cast<Cell>(e.count);
+                }
+            }
+        }
+        status_[row / n_] = ok ? kPayable : kUnpayable;
+    }
+
+public:
+
+    /**
+     * @param inner     strategy whose answers are cached
+     * @param maxAmount largest cached amount (the insert limit)
+     * @param step      gcd of the insertable notes
+     */
+    CachedChangeMaker(std::unique_ptr<IChangeMaker> inner, int maxAmount, int step = 1)
+        : inner_(std::move(inner)),
+          n_(inner_->denominations().size()),
+          maxAmount_(std::clamp(maxAmount, 0, int{INT16_MAX})),
+          step_(std::max(step, 1)) {
+        const std::size_t rows = static_cast<std::size_t>(maxAmount_ / step_) + 1;
+        status_.assign(rows, kUnknown);
+        notes_.assign(rows * n_, 0);
+        need_.resize(rows * n_);
+        seen_.assign(rows * n_, 0);
+
+        const std::vector<int>& denoms = inner_->denominations();
+        for (std::size_t a = 0; a < rows; ++a)
+            for (std::size_t i = 0; i < n_; ++i)
+                need_[a * n_ + i] = static_cast<Cell>(static_cast<int>(a) * step_ / denoms[i]);
+    }
+
+    bool makeChange(int amount,
+                    const CashInventory& inventory,
+                    PayoutPlan& plan) override {
+        if (amount < 0 || amount > maxAmount_ || amount % step_ != 0)
+            return inner_->makeChange(amount, inventory, plan);
+
+        const std::size_t a = static_cast<std::size_t>(amount / step_);
+        const std::size_t row = a * n_;
+
+        if (status_[a] != kUnknown && fresh(row, inventory)) {
+            ++hits_;
+            if (status_[a] == kUnpayable)
+                return false;
+
+            const std::vector<int>& denoms = inner_->denominations();
+            plan.clear();
+            for (std::size_t i = 0; i < n_; ++i)
+                plan.add(denoms[i], notes_[row + i]);
+            return true;
+        }
+
+        ++misses_;
+        const bool ok = inner_->makeChange(amount, inventory, plan);
+        store(row, ok, inventory, plan);
+        return ok;
+    }
+
+    /**
+     * @brief Fill every row up front from the current inventory.
+     */
+    void precompute(const CashInventory& inventory, PayoutPlan& scratch) {
+        for (int amount = 0; amount <= maxAmount_; amount += step_) {
+            const std::size_t row = static_cast<std::size_t>(amount / step_) * n_;
+            store(row, inner_->makeChange(amount, inventory, scratch), inventory, scratch);
+        }
+    }
+
+    const std::vector<int>& denominations() const override {
+        return inner_->denominations();
+    }
+
+    const char* name() const override { return "Cached"; }
+
+    long hits() const { return hits_; }
+    long misses() const { return misses_; }
+};
@@ -0,0 +1,125 @@
+/**
+ * @file contention_bench.cpp
+ * @brief Multi-terminal benchmark: N terminals sharing one cash pool.
+ *
+ * @details
+ * Every thread drives its own CashExchangeMachine (terminal). All
+ * terminals are built from the same std::shared_ptr<CashInventory>,
+ * so every insert and every payout hits the same lock-free counters.
+ *
+ * Each terminal inserts a random note (5/10/20/50 EUR) and exchanges
+ * it. The run is repeated for 1, 2, 4, ... N threads and reports the
+ * aggregate exchanges per second. A failed exchange is cancelled, which
+ * hands the note back if the pool still can. After each run the pool
+ * is checked: no count may be negative and the total cash must equal
+ * the start value plus what terminals still hold (refunds that failed).
+ *
+ * @usage
+ * g++ -std=c++17 -O2 -pthread contention_bench.cpp -o contention_bench
+ * ./contention_bench [max_threads] [exchanges_per_thread]
+ */
+
+#include "cash_exchange_machine.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Total cash held by an inventory.
+ */
+long totalCash(const CashInventory& inventory) {
+    long total = 0;
+    for (const auto& [denom, count] : inventory.data())
+        total += static_cast<long>(denom) * count;
+    return total;
+}
+
+/**
+ * @brief Lowest count of any denomination.
+ */
+int lowestCount(const CashInventory& inventory) {
+    int lowest = 0;
+    bool first = true;
+    for (const auto& [denom, count] : inventory.data()) {
+        (void)denom;
+        if (first || count < lowest)
+            lowest = count;
+        first = false;
+    }
+    return lowest;
+}
+
+int main(int argc, char* argv[]) {
+
+    unsigned hw = std::thread::hardware_concurrency();
+    int maxThreads = (argc > 1) ? std::atoi(argv[1]) : static_cast<int>(hw ? hw : 4);
+    long perThread = (argc > 2) ? std::atol(argv[2]) : 1'000'000L;
+
+    std::cout << "Exchanges per thread: " << perThread << "\n";
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+
+        auto pool = std::make_shared<CashInventory>();
+        const long cashBefore = totalCash(*pool);
+
+        std::atomic<long> failures{0};
+        std::atomic<long> kept{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                CashExchangeMachine terminal(pool);
+
+                std::mt19937 rng(static_cast<unsigned>(t) + 1);
+                const int notes[] = {5, 10, 20, 50};
+                long failed = 0;
+
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+
+                // Status API: nothing may throw out of a worker thread
+                for (long i = 0; i < perThread; ++i) {
+                    if (terminal.tryInsertMoney(notes[rng() % 4]).ok() &&
+                        terminal.tryExchange().ok())
+                        continue;
+                    // Pool raced dry for this amount (or notes left from a failed
+                    // refund pushed the insert over the limit) - hand the notes
+                    // back; if even that fails they stay inserted for the next round
+                    ++failed;
+                    terminal.tryCancel();
+                }
+                failures += failed;
+                kept += static_cast<long>(terminal.getInserted().units());
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread& w : workers)
+            w.join();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        const long total = perThread * threads;
+        const bool consistent = totalCash(*pool) == cashBefore + kept.load() &&
+                                lowestCount(*pool) >= 0;
+
+        std::cout << threads << " thread(s): "
+                  << static_cast<long>(total / elapsed.count()) << " exchanges/s"
+                  << ", failed " << failures.load()
+                  << ", pool " << (consistent ? "consistent" : "CORRUPTED")
+                  << "\n";
+
+        if (!consistent)
+            return 1;
+    }
+
+    return 0;
+}
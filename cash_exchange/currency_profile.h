@@ -0,0 +1,319 @@
+/**
+ * @file currency_profile.h
+ * @brief Currency profiles: accepted denominations, limits, payout set.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* ============================================================
+   ENUM CLASS  →  TYPE SAFETY + STRONG ENUMERATION
+   OOP Concept: Strong typing / Scoped enum
+   ============================================================ */
+
+/**
+ * @enum Denomination
+ * @brief Represents valid Euro denominations (built-in EUR profile).
+ */
+enum class Denomination {
+    EUR_5   = 5,
+    EUR_10  = 10,
+    EUR_20  = 20,
+    EUR_50  = 50,
+    EUR_100 = 100
+};
+
+/// Every built-in denomination in slot order (ascending value)
+inline constexpr std::array<Denomination, 5> kDenominations{
+    Denomination::EUR_5,
+    Denomination::EUR_10,
+    Denomination::EUR_20,
+    Denomination::EUR_50,
+    Denomination::EUR_100
+};
+
+/// Upper bound of denominations per profile (sizes inventory slots)
+inline constexpr std::size_t kMaxDenominations = 16;
+
+/* ============================================================
+   CURRENCY PROFILE
+   OOP Concept Applied: Encapsulation + Immutability
+   ============================================================ */
+
+/**
+ * @class CurrencyProfile
+ * @brief Immutable lookup tables of one currency.
+ *
+ * A profile knows which denominations are accepted (one dense slot
+ * each, ascending), the insert limit, the initial stock and which
+ * denominations are paid out. Validating a value is one range check
+ * plus one load from the value → slot table, instead of a chain of
+ * comparisons. The table spans face values up to kMaxTableValue; a
+ * currency with larger notes falls back to a binary search over its
+ * (at most kMaxDenominations) values rather than a huge table.
+ *
+ * Profiles are built once at startup and never change afterwards, so
+ * any number of machines - in any mix of currencies - can share them.
+ * A machine binds its profile at construction; there is no per-call
+ * cost for picking the table.
+ */
+class CurrencyProfile {
+public:
+
+    /// Largest face value the value → slot table covers (64 KiB)
+    static constexpr int kMaxTableValue = 65535;
+
+private:
+
+    std::string code_;                          ///< e.g. "EUR"
+    int limit_;                                 ///< max inserted amount
+    std::vector<int> values_;                   ///< slot → value, ascending
+    std::vector<int> initialStock_;             ///< slot → initial count
+    std::vector<int> payout_;                   ///< payout values, descending
+    std::vector<signed char> slotByValue_;      ///< value → slot, -1 if invalid; empty = search
+
+public:
+
+    /**
+     * @brief Build a profile.
+     * @param code   currency code
+     * @param limit  maximum inserted amount per transaction
+     * @param stock  (denomination, initial count) pairs
+     * @param payout denominations paid out on exchange
+     *
+     * Throws std::invalid_argument for an inconsistent profile.
+     */
+    CurrencyProfile(std::string code,
+                    int limit,
+                    std::vector<std::pair<int, int>> stock,
+                    std::vector<int> payout)
+        : code_(std::move(code)), limit_(limit), payout_(std::move(payout)) {
+
+        if (stock.empty() || stock.size() > kMaxDenominations)
+            throw std::invalid_argument("Profile " + code_ + ": bad denomination count.");
+        if (limit_ <= 0)
+            throw std::invalid_argument("Profile " + code_ + ": bad insert limit.");
+
+        std::sort(stock.begin(), stock.end());
+        for (std::size_t i = 0; i < stock.size(); ++i) {
+            if (stock[i].first <= 0 || stock[i].second < 0 ||
+                (i > 0 && stock[i].first == stock[i - 1].first))
+                throw std::invalid_argument("Profile " + code_ + ": bad denomination.");
+            values_.push_back(stock[i].first);
+            initialStock_.push_back(stock[i].second);
+        }
+
+        if (values_.back() <= kMaxTableValue) {
+            slotByValue_.assign(static_cast<std::size_t>(values_.back()) + 1, -1);
+            for (std::size_t i = 0; i < values_.size(); ++i)
+                slotByValue_[static_cast<std::size_t>(values_[i])] = static_cast<signed char>(i);
+        }
+
+        std::sort(payout_.begin(), payout_.end(), std::greater<int>());
+        if (std::adjacent_find(payout_.begin(), payout_.end()) != payout_.end())
+            throw std::invalid_argument("Profile " + code_ + ": duplicate payout note.");
+        for (int d : payout_)
+            if (slotOf(d) < 0)
+                throw std::invalid_argument("Profile " + code_ + ": payout note not accepted.");
+    }
+
+    /**
+     * @brief Built-in EUR profile: 5-100 EUR notes, 500 EUR limit.
+     */
+    static const CurrencyProfile& eur() {
+        static const CurrencyProfile profile(
+            "EUR", 500,
+            {{static_cast<int>(Denomination::EUR_5), 20},
+             {static_cast<int>(Denomination::EUR_10), 20},
+             {static_cast<int>(Denomination::EUR_20), 20},
+             {static_cast<int>(Denomination::EUR_50), 10},
+             {static_cast<int>(Denomination::EUR_100), 5}},
+            {50, 20, 10, 5});
+        return profile;
+    }
+
+    /**
+     * @brief Dense slot of a value.
+     * @return slot index, or -1 if value is not a denomination
+     *
+     * One range check plus one table load - no search, no tree walk -
+     * unless the notes are too large for the table.
+     */
+    int slotOf(int value) const {
+        if (static_cast<std::size_t>(value) < slotByValue_.size())
+            return slotByValue_[static_cast<std::size_t>(value)];
+        if (!slotByValue_.empty())
+            return -1;   // the table covers every note
+
+        auto it = std::lower_bound(values_.begin(), values_.end(), value);
+        return it != values_.end() && *it == value ? static_cast<int>(it - values_.begin()) : -1;
+    }
+
+    bool accepts(int value) const {
+        return slotOf(value) >= 0;
+    }
+
+    /**
+     * @brief Number of denominations (slots).
+     */
+    std::size_t size() const {
+        return values_.size();
+    }
+
+    /**
+     * @brief Denomination stored in a slot.
+     */
+    int value(std::size_t slot) const {
+        return values_[slot];
+    }
+
+    int initialStock(std::size_t slot) const {
+        return initialStock_[slot];
+    }
+
+    const std::vector<int>& payoutDenominations() const {
+        return payout_;
+    }
+
+    const std::string& code() const {
+        return code_;
+    }
+
+    int limit() const {
+        return limit_;
+    }
+};
+
+/* ============================================================
+   CURRENCY REGISTRY
+   Loads profiles once at startup.
+   ============================================================ */
+
+/**
+ * @class CurrencyRegistry
+ * @brief Owns every loaded CurrencyProfile.
+ *
+ * Config format, one profile per line ('#' starts a comment):
+ *
+ *   <code> <limit> <value>:<stock> ... | <payout value> ...
+ *
+ *   EUR 500 5:20 10:20 20:20 50:10 100:5 | 50 20 10 5
+ *
+ * Profiles live in a std::deque, so references handed out stay valid
+ * while more profiles are added.
+ */
+class CurrencyRegistry {
+private:
+
+    std::deque<CurrencyProfile> profiles_;
+
+    /**
+     * @brief Whole-token integer, or an error naming the line and profile.
+     */
+    static int number(const std::string& token, int lineNo, const std::string& code) {
+        std::size_t used = 0;
+        int value = 0;
+        try {
+            value = std::stoi(token, &used);
+        } catch (const std::logic_error&) {
+            used = 0;   // invalid_argument or out_of_range
+        }
+        if (used == 0 || used != token.size())
+            throw std::invalid_argument("Line " + std::to_string(lineNo) + ": profile " + code +
+                                        ": bad number '" + token + "'.");
+        return value;
+    }
+
+public:
+
+    /**
+     * @brief Parse profiles from a stream.
+     */
+    void load(std::istream& in) {
+        std::string line;
+        int lineNo = 0;
+
+        while (std::getline(in, line)) {
+            ++lineNo;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream fields(line);
+            std::string code;
+            int limit = 0;
+            if (!(fields >> code))
+                continue;
+            if (!(fields >> limit))
+                throw std::invalid_argument("Line " + std::to_string(lineNo) + ": missing limit.");
+
+            std::vector<std::pair<int, int>> stock;
+            std::vector<int> payout;
+            bool inPayout = false;
+            std::string token;
+
+            while (fields >> token) {
+                if (token == "|") {
+                    inPayout = true;
+                } else if (inPayout) {
+                    payout.push_back(number(token, lineNo, code));
+                } else {
+                    std::size_t colon = token.find(':');
+                    int value = number(token.substr(0, colon), lineNo, code);
+                    int count = colon == std::string::npos
+                                    ? 0
+                                    : number(token.substr(colon + 1), lineNo, code);
+                    stock.emplace_back(value, count);
+                }
+            }
+
+            if (find(code))
+                throw std::invalid_argument("Line " + std::to_string(lineNo) + ": duplicate " + code + ".");
+            profiles_.emplace_back(code, limit, std::move(stock), std::move(payout));
+        }
+    }
+
+    /**
+     * @brief Parse profiles from a config file.
+     */
+    void loadFile(const std::string& path) {
+        std::ifstream in(path);
+        if (!in)
+            throw std::runtime_error("Cannot open currency config " + path + ".");
+        load(in);
+    }
+
+    /**
+     * @brief Profile by currency code, nullptr if unknown.
+     */
+    const CurrencyProfile* find(const std::string& code) const {
+        for (const CurrencyProfile& p : profiles_)
+            if (p.code() == code)
+                return &p;
+        return nullptr;
+    }
+
+    const CurrencyProfile& at(const std::string& code) const {
+        const CurrencyProfile* p = find(code);
+        if (!p)
+            throw std::out_of_range("Unknown currency " + code + ".");
+        return *p;
+    }
+
+    std::deque<CurrencyProfile>::const_iterator begin() const {
+        return profiles_.begin();
+    }
+
+    std::deque<CurrencyProfile>::const_iterator end() const {
+        return profiles_.end();
+    }
+};
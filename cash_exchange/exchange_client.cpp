@@ -0,0 +1,222 @@
+/**
+ * @file exchange_client.cpp
+ * @brief Local load tester for exchange_server.
+ *
+ * @details
+ * Opens N kiosk connections (one thread each). Every kiosk loops over
+ * customer transactions - 1-3 random notes, then an exchange - and
+ * keeps `pipeline` transactions in flight: the requests of a whole
+ * pipeline go out in one write, then all responses are read back.
+ *
+ * Reports requests per second over all kiosks, round-trip latency
+ * percentiles per pipeline and the response status mix, and checks
+ * that every response answers the request it belongs to.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 -pthread exchange_client.cpp -o exchange_client
+ * ./exchange_client [socket_path] [kiosks] [seconds] [pipeline]
+ */
+
+#include "exchange_protocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @struct KioskResult
+ * @brief What one kiosk thread saw.
+ */
+struct KioskResult {
+    long requests{0};
+    long ok{0};
+    long rejected{0};
+    long partial{0};
+    long idle{0};       ///< exchanges with nothing inserted
+    long unrecorded{0}; ///< done, but the server's journal failed
+    long mismatched{0};
+    std::vector<std::uint64_t> roundTrips;   ///< ns per pipeline
+};
+
+int connectTo(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "socket");
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "connect " + path);
+    }
+    return fd;
+}
+
+void sendAll(int fd, const void* data, std::size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            throw std::system_error(errno, std::generic_category(), "send");
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+}
+
+void receiveAll(int fd, void* data, std::size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            throw std::runtime_error("Server closed the connection.");
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+}
+
+/**
+ * @brief One kiosk: pipelined transactions until `deadline`.
+ */
+void kiosk(const std::string& path, unsigned seed, int pipeline,
+           std::chrono::steady_clock::time_point deadline,
+           KioskResult& result) {
+    using Clock = std::chrono::steady_clock;
+
+    const int notes[] = {5, 10, 20, 50, 100};
+    std::mt19937 rng(seed);
+
+    int fd = connectTo(path);
+
+    std::vector<wire::Request> requests;
+    std::vector<wire::Response> responses;
+    requests.reserve(static_cast<std::size_t>(pipeline) * 4);
+    responses.reserve(static_cast<std::size_t>(pipeline) * 4);
+
+    std::uint32_t id = 0;
+    try {
+        while (Clock::now() < deadline) {
+            requests.clear();
+            for (int t = 0; t < pipeline; ++t) {
+                int count = 1 + static_cast<int>(rng() % 3);
+                for (int i = 0; i < count; ++i)
+                    requests.push_back({id++, wire::Op::Insert, {}, notes[rng() % 5]});
+                requests.push_back({id++, wire::Op::Exchange, {}, 0});
+            }
+            responses.resize(requests.size());
+
+            auto t0 = Clock::now();
+            sendAll(fd, requests.data(), requests.size() * sizeof(wire::Request));
+            receiveAll(fd, responses.data(), responses.size() * sizeof(wire::Response));
+            result.roundTrips.push_back(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count()));
+
+            for (std::size_t i = 0; i < responses.size(); ++i) {
+                const wire::Response& r = responses[i];
+                if (r.id != requests[i].id)
+                    ++result.mismatched;
+                switch (r.status) {
+                case wire::Status::Ok:       ++result.ok; break;
+                case wire::Status::Rejected: ++result.rejected; break;
+                case wire::Status::Partial:  ++result.partial; break;
+                case wire::Status::NothingInserted: ++result.idle; break;
+                case wire::Status::JournalFailed: ++result.unrecorded; break;
+                default:                     ++result.mismatched; break;
+                }
+            }
+            result.requests += static_cast<long>(responses.size());
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string path = (argc > 1) ? argv[1] : "/tmp/cash_exchange.sock";
+    int kiosks = (argc > 2) ? std::atoi(argv[2]) : 4;
+    double seconds = (argc > 3) ? std::atof(argv[3]) : 3.0;
+    int pipeline = (argc > 4) ? std::atoi(argv[4]) : 16;
+
+    kiosks = std::max(kiosks, 1);
+    pipeline = std::max(pipeline, 1);
+
+    std::vector<KioskResult> results(static_cast<std::size_t>(kiosks));
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(seconds));
+
+    for (int k = 0; k < kiosks; ++k) {
+        threads.emplace_back([&, k] {
+            try {
+                kiosk(path, static_cast<unsigned>(k) + 1, pipeline, deadline,
+                      results[static_cast<std::size_t>(k)]);
+            } catch (const std::exception& e) {
+                std::cerr << "[EXCEPTION] kiosk " << k << ": " << e.what() << "\n";
+                failed = true;
+            }
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    KioskResult total;
+    for (KioskResult& r : results) {
+        total.requests += r.requests;
+        total.ok += r.ok;
+        total.rejected += r.rejected;
+        total.partial += r.partial;
+        total.idle += r.idle;
+        total.unrecorded += r.unrecorded;
+        total.mismatched += r.mismatched;
+        total.roundTrips.insert(total.roundTrips.end(), r.roundTrips.begin(), r.roundTrips.end());
+    }
+    std::sort(total.roundTrips.begin(), total.roundTrips.end());
+
+    auto at = [&total](double q) -> std::uint64_t {
+        if (total.roundTrips.empty())
+            return 0;
+        return total.roundTrips[static_cast<std::size_t>(
+            q * static_cast<double>(total.roundTrips.size() - 1))];
+    };
+
+    std::cout << "Kiosks: " << kiosks << ", pipeline: " << pipeline << " transactions\n"
+              << "Requests: " << total.requests << " in " << elapsed.count() << " s ("
+              << static_cast<long>(static_cast<double>(total.requests) / elapsed.count())
+              << " requests/s)\n"
+              << "Status: ok " << total.ok << ", rejected " << total.rejected
+              << ", partial " << total.partial << ", nothing inserted " << total.idle
+              << ", not journaled " << total.unrecorded << "\n"
+              << "Round trip per pipeline: p50 " << at(0.50) / 1000 << " us, p99 "
+              << at(0.99) / 1000 << " us\n"
+              << (total.mismatched ? "RESPONSES OUT OF ORDER!" : "All responses in order.") << "\n";
+
+    return (failed || total.mismatched) ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file exchange_protocol.h
+ * @brief Fixed-size binary messages between kiosks and the machine server.
+ */
+#pragma once
+
+#include "cash_exchange_machine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/* ============================================================
+   WIRE FORMAT
+   Concept: Fixed-size records, no parsing
+   ============================================================ */
+
+/**
+ * Every request and every response has one fixed size, so a reader
+ * only ever needs "have I got N bytes yet" - no length prefixes, no
+ * text parsing. Fields are in host byte order: both ends run on the
+ * same host (Unix-domain socket).
+ *
+ * Requests are answered in order; `id` is echoed back so a client can
+ * pipeline many requests on one connection.
+ */
+namespace wire {
+
+enum class Op : std::uint8_t {
+    Insert = 1,     ///< amount = note inserted
+    Exchange = 2,   ///< pay out everything inserted so far
+    Status = 3,     ///< inserted amount + pool counts
+    Cancel = 4      ///< hand the inserted notes back
+};
+
+enum class Status : std::uint8_t {
+    Ok = 0,
+    Rejected = 1,   ///< invalid note or over the insert limit
+    Partial = 2,    ///< no valid payout; the inserted notes come back
+    BadRequest = 3, ///< unknown op
+    NothingInserted = 4,  ///< exchange with nothing inserted (no-op)
+    JournalFailed = 5     ///< done (entries valid), but not journaled
+};
+
+/// Payout or refund notes (Exchange, Cancel) or pool counts (Status)
+constexpr std::size_t kMaxEntries = kMaxDenominations;
+
+/**
+ * @struct Request
+ * @brief 12 bytes, client → server.
+ */
+struct Request {
+    std::uint32_t id;
+    Op op;
+    std::uint8_t reserved[3];
+    std::int32_t amount;       ///< Insert: note value in whole units
+};
+
+/**
+ * @struct Entry
+ * @brief One (note, count) pair.
+ */
+struct Entry {
+    std::int32_t denomination;
+    std::int32_t count;
+};
+
+/**
+ * @struct Response
+ * @brief 140 bytes, server → client.
+ */
+struct Response {
+    std::uint32_t id;
+    Status status;
+    std::uint8_t entries;      ///< valid items in `entry`
+    std::uint8_t hasMoney;     ///< 1 = machine waits for more notes/exchange
+    std::uint8_t reserved;
+    std::int32_t insertedCents; ///< amount inserted after this request
+    Entry entry[kMaxEntries];
+};
+
+static_assert(sizeof(Request) == 12, "request layout is part of the protocol");
+static_assert(sizeof(Response) == 12 + 8 * kMaxEntries, "response layout is part of the protocol");
+static_assert(std::is_trivially_copyable_v<Request> &&
+                  std::is_trivially_copyable_v<Response>,
+              "messages are copied as raw bytes");
+
+/**
+ * @brief Cancel the transaction; the notes handed back go into `res`.
+ */
+inline MachineStatus refund(CashExchangeMachine& machine, Response& res) {
+    ExchangeResult result = machine.tryCancel();
+    if (result.dispensed()) {
+        for (const PayoutEntry& e : result.payout)
+            res.entry[res.entries++] = {e.denomination, e.count};
+    }
+    return result.status;
+}
+
+/**
+ * @brief Run one request through a machine (its states decide).
+ *
+ * Uses the exception-free machine API, so a rejected note costs a
+ * status code, not an unwind. A partial exchange cancels the
+ * transaction: the response carries the notes handed back. If even
+ * that is impossible (a shared pool emptied meanwhile) the response
+ * has no entries and hasMoney stays 1, so the kiosk can retry or
+ * cancel later.
+ *
+ * Never throws: a journal I/O error is answered with JournalFailed,
+ * and the event itself (note accepted, notes paid) still counts.
+ */
+inline void handle(CashExchangeMachine& machine, const Request& req, Response& res) {
+    std::memset(&res, 0, sizeof(res));
+    res.id = req.id;
+
+    switch (req.op) {
+    case Op::Insert:
+        switch (machine.tryInsertMoney(req.amount).status) {
+        case MachineStatus::Ok:
+            break;
+        case MachineStatus::JournalFailed:
+            res.status = Status::JournalFailed;
+            break;
+        default:
+            res.status = Status::Rejected;
+            break;
+        }
+        break;
+
+    case Op::Exchange: {
+        ExchangeResult result = machine.tryExchange();
+        if (result.dispensed()) {
+            for (const PayoutEntry& e : result.payout)
+                res.entry[res.entries++] = {e.denomination, e.count};
+            if (!result.ok())
+                res.status = Status::JournalFailed;
+        } else if (result.status == MachineStatus::NothingInserted) {
+            res.status = Status::NothingInserted;
+        } else {
+            res.status = Status::Partial;
+            refund(machine, res);
+        }
+        break;
+    }
+
+    case Op::Cancel:
+        switch (refund(machine, res)) {
+        case MachineStatus::Ok:
+            break;
+        case MachineStatus::NothingInserted:
+            res.status = Status::NothingInserted;
+            break;
+        case MachineStatus::JournalFailed:
+            res.status = Status::JournalFailed;
+            break;
+        default:
+            res.status = Status::Partial;
+            break;
+        }
+        break;
+
+    case Op::Status:
+        for (const auto& [denom, count] : machine.inventory().data())
+            res.entry[res.entries++] = {denom, count};
+        break;
+
+    default:
+        res.status = Status::BadRequest;
+        break;
+    }
+
+    res.insertedCents = static_cast<std::int32_t>(machine.getInserted().cents());
+    res.hasMoney = machine.hasMoney() ? 1 : 0;
+}
+
+} // namespace wire
@@ -0,0 +1,429 @@
+/**
+ * @file exchange_server.cpp
+ * @brief Unix-domain-socket front-end for the cash exchange machine.
+ *
+ * @details
+ * Kiosks connect over a local stream socket and speak the fixed-size
+ * binary protocol of exchange_protocol.h. Every connection is one
+ * terminal: a CashExchangeMachine of its own (states, inserted
+ * amount) drawing from one shared CashInventory.
+ *
+ * One thread, one epoll loop, non-blocking sockets:
+ * - a wakeup drains every ready socket into its input buffer
+ * - all complete requests of that batch run through the machine
+ * - all responses of the batch go out with one write per socket;
+ *   whatever the socket does not take waits for EPOLLOUT
+ * - a kiosk that does not read its responses (more than
+ *   Connection::kMaxPending owed) is not read from until they drain,
+ *   and one that has closed its side is only watched for EPOLLOUT
+ * - a kiosk that goes away mid-transaction has its notes refunded to
+ *   the pool's payout (counted as an aborted transaction)
+ *
+ * SIGINT / SIGTERM stop the loop and print a summary.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 exchange_server.cpp -o exchange_server
+ * ./exchange_server [socket_path]      (default: /tmp/cash_exchange.sock)
+ */
+
+#include "cash_exchange_machine.h"
+#include "exchange_protocol.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+volatile std::sig_atomic_t gStop = 0;
+
+void onSignal(int) {
+    gStop = 1;
+}
+
+} // namespace
+
+/* ============================================================
+   CONNECTION
+   ============================================================ */
+
+/**
+ * @class Connection
+ * @brief One kiosk: socket, its terminal machine and I/O buffers.
+ */
+class Connection {
+
+public:
+
+    /// Response bytes owed above which the socket is not read from
+    static constexpr std::size_t kMaxPending = 64 * 1024;
+
+private:
+
+    int fd_;
+    CashExchangeMachine machine_;
+
+    std::vector<unsigned char> in_;    ///< received, not yet handled
+    std::vector<unsigned char> out_;   ///< responses not yet written
+    std::size_t sent_{0};              ///< bytes of out_ already written
+    bool inputOpen_{true};             ///< peer has not shut down its side
+    std::uint32_t watched_{0};         ///< events registered with epoll
+
+    /// Responses not yet written plus those the buffered requests will produce
+    std::size_t owed() const {
+        return out_.size() - sent_ +
+               in_.size() / sizeof(wire::Request) * sizeof(wire::Response);
+    }
+
+public:
+
+    Connection(int fd, std::shared_ptr<CashInventory> pool)
+        : fd_(fd), machine_(std::move(pool)) {
+        in_.reserve(64 * sizeof(wire::Request));
+        out_.reserve(64 * sizeof(wire::Response));
+    }
+
+    ~Connection() {
+        ::close(fd_);
+    }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    int fd() const {
+        return fd_;
+    }
+
+    /**
+     * @brief Read what is available, up to kMaxPending of responses owed.
+     * @return false if the socket failed
+     */
+    bool receive() {
+        unsigned char buf[16 * 1024];
+        while (!backlogged()) {
+            ssize_t n = ::read(fd_, buf, sizeof(buf));
+            if (n > 0) {
+                in_.insert(in_.end(), buf, buf + n);
+                continue;
+            }
+            if (n == 0) {
+                inputOpen_ = false;
+                return true;
+            }
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Handle every complete request of the batch.
+     * @return requests handled
+     */
+    long process() {
+        const std::size_t count = in_.size() / sizeof(wire::Request);
+        if (count == 0)
+            return 0;
+
+        const std::size_t base = out_.size();
+        out_.resize(base + count * sizeof(wire::Response));
+
+        wire::Request req;
+        wire::Response res;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(&req, in_.data() + i * sizeof(req), sizeof(req));
+            wire::handle(machine_, req, res);
+            std::memcpy(out_.data() + base + i * sizeof(res), &res, sizeof(res));
+        }
+
+        // Keep a trailing partial request for the next wakeup
+        in_.erase(in_.begin(), in_.begin() + static_cast<long>(count * sizeof(wire::Request)));
+        return static_cast<long>(count);
+    }
+
+    /**
+     * @brief Write pending responses.
+     * @return false if the socket failed
+     */
+    bool flush() {
+        while (sent_ < out_.size()) {
+            ssize_t n = ::send(fd_, out_.data() + sent_, out_.size() - sent_, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent_ += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return true;
+            return false;
+        }
+        out_.clear();
+        sent_ = 0;
+        return true;
+    }
+
+    bool pending() const {
+        return sent_ < out_.size();
+    }
+
+    /// A transaction is open (notes inserted, not yet exchanged)
+    bool midTransaction() const {
+        return machine_.getInserted() > Money();
+    }
+
+    /**
+     * @brief Cancel the open transaction of a kiosk that went away.
+     * @return false if the pool could not pay the notes back
+     */
+    bool abort() {
+        return machine_.tryCancel().dispensed();
+    }
+
+    /// Too many responses owed: stop reading until they drain
+    bool backlogged() const {
+        return owed() > kMaxPending;
+    }
+
+    bool inputOpen() const {
+        return inputOpen_;
+    }
+
+    /// Nothing more will come in or go out
+    bool finished() const {
+        return !inputOpen_ && !pending();
+    }
+
+    /**
+     * @brief Events this connection needs now.
+     *
+     * Input only while the peer still sends and responses are not
+     * piling up; after its shutdown only EPOLLOUT, or a level-triggered
+     * EPOLLRDHUP would wake the loop forever.
+     */
+    std::uint32_t interest() const {
+        std::uint32_t events = 0;
+        if (inputOpen_ && !backlogged())
+            events |= EPOLLIN | EPOLLRDHUP;
+        if (pending())
+            events |= EPOLLOUT;
+        return events;
+    }
+
+    std::uint32_t watched() const {
+        return watched_;
+    }
+
+    void setWatched(std::uint32_t events) {
+        watched_ = events;
+    }
+};
+
+/* ============================================================
+   EVENT LOOP
+   ============================================================ */
+
+/**
+ * @class ExchangeServer
+ * @brief Accepts kiosks and drives their machines from one epoll loop.
+ */
+class ExchangeServer {
+
+private:
+
+    std::string path_;
+    int listen_{-1};
+    int epoll_{-1};
+
+    std::shared_ptr<CashInventory> pool_;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+
+    long requests_{0};
+    long wakeups_{0};
+    long accepted_{0};
+    long aborted_{0};       ///< kiosks gone mid-transaction
+    long unrefunded_{0};    ///< of those, refunds the pool could not pay
+
+    void watch(int fd, std::uint32_t events, int op) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (::epoll_ctl(epoll_, op, fd, &ev) < 0)
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+    }
+
+    void acceptAll() {
+        for (;;) {
+            int fd = ::accept4(listen_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR)
+                    continue;
+                return;   // EAGAIN, or a client that already gave up
+            }
+            auto c = std::make_unique<Connection>(fd, pool_);
+            c->setWatched(c->interest());
+            watch(fd, c->watched(), EPOLL_CTL_ADD);
+            connections_.emplace(fd, std::move(c));
+            ++accepted_;
+        }
+    }
+
+    void drop(int fd) {
+        auto it = connections_.find(fd);
+        if (it == connections_.end())
+            return;
+
+        // Notes already sit in the shared pool: give them back through the machine
+        Connection& c = *it->second;
+        if (c.midTransaction()) {
+            ++aborted_;
+            if (!c.abort())
+                ++unrefunded_;
+        }
+
+        ::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+        connections_.erase(it);   // closes the socket
+    }
+
+    void serve(Connection& c, std::uint32_t events) {
+        bool ok = true;
+        if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && c.inputOpen())
+            ok = c.receive();
+
+        requests_ += c.process();
+
+        if (!ok || !c.flush() || c.finished()) {
+            drop(c.fd());
+            return;
+        }
+
+        // Re-register only when the needed events change
+        if (c.interest() != c.watched()) {
+            c.setWatched(c.interest());
+            watch(c.fd(), c.watched(), EPOLL_CTL_MOD);
+        }
+    }
+
+public:
+
+    explicit ExchangeServer(std::string path)
+        : path_(std::move(path)),
+          pool_(std::make_shared<CashInventory>()) {
+
+        if (path_.size() >= sizeof(sockaddr_un::sun_path))
+            throw std::invalid_argument("Socket path too long.");
+
+        listen_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_ < 0)
+            throw std::system_error(errno, std::generic_category(), "socket");
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(path_.c_str());
+
+        if (::bind(listen_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(listen_, SOMAXCONN) < 0) {
+            int err = errno;
+            ::close(listen_);
+            throw std::system_error(err, std::generic_category(), "bind/listen " + path_);
+        }
+
+        epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_ < 0) {
+            int err = errno;
+            ::close(listen_);
+            throw std::system_error(err, std::generic_category(), "epoll_create1");
+        }
+        watch(listen_, EPOLLIN, EPOLL_CTL_ADD);
+    }
+
+    ~ExchangeServer() {
+        connections_.clear();
+        ::close(epoll_);
+        ::close(listen_);
+        ::unlink(path_.c_str());
+    }
+
+    ExchangeServer(const ExchangeServer&) = delete;
+    ExchangeServer& operator=(const ExchangeServer&) = delete;
+
+    void run() {
+        epoll_event events[256];
+
+        while (!gStop) {
+            int n = ::epoll_wait(epoll_, events, 256, 500);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "epoll_wait");
+            }
+            if (n > 0)
+                ++wakeups_;
+
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listen_) {
+                    acceptAll();
+                    continue;
+                }
+                auto it = connections_.find(fd);
+                if (it != connections_.end())
+                    serve(*it->second, events[i].events);
+            }
+        }
+
+        // Shutdown ends every open transaction too
+        while (!connections_.empty())
+            drop(connections_.begin()->first);
+    }
+
+    void printSummary() const {
+        std::cout << "\nConnections: " << accepted_
+                  << ", requests: " << requests_
+                  << ", wakeups: " << wakeups_;
+        if (wakeups_ > 0)
+            std::cout << " (" << static_cast<double>(requests_) / static_cast<double>(wakeups_)
+                      << " requests per wakeup)";
+        std::cout << "\nAborted transactions: " << aborted_
+                  << " (" << unrefunded_ << " not refunded)";
+        std::cout << "\n\nPool:\n";
+        for (const auto& [denom, count] : pool_->data())
+            std::cout << denom << " " << pool_->profile().code() << " : " << count << "\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+    std::string path = (argc > 1) ? argv[1] : "/tmp/cash_exchange.sock";
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    try {
+        ExchangeServer server(path);
+        std::cout << "Listening on " << path << "\n";
+        server.run();
+        server.printSummary();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[EXCEPTION] " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
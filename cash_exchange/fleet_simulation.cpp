@@ -0,0 +1,277 @@
+/**
+ * @file fleet_simulation.cpp
+ * @brief Discrete-event simulation of a fleet of cash exchange machines.
+ *
+ * @details
+ * Simulates thousands of CashExchangeMachine instances, each with its
+ * own CashInventory, to plan refills. Machines are split into shards;
+ * every worker thread owns one shard and runs it on its own
+ * discrete-event clock (a min-heap of "next customer" events), so the
+ * shards share nothing and the run scales with the number of cores.
+ *
+ * Each machine gets its own customer rate (busy and quiet sites).
+ * A customer inserts 1-3 notes and asks for an exchange. A machine is
+ * "depleted" at its first partial exchange (no valid payout left); the
+ * customer then cancels and gets the notes back.
+ *
+ * Every machine feeds a RefillPlanner. With a refill interval set, an
+ * operator visits the shard every `refill_hours` and loads what the
+ * planner recommends for the next interval.
+ *
+ * Output:
+ * - fleet summary: simulated vs. wall-clock time, events per second,
+ *   depletion-time percentiles and the average partial-exchange rate
+ * - notes loaded by refills
+ * - optional CSV with one line per machine:
+ *   machine,customers_per_hour,transactions,partial,depleted_after_h,notes_loaded
+ *
+ * @usage
+ * g++ -std=c++17 -O2 -pthread fleet_simulation.cpp -o fleet_simulation
+ * ./fleet_simulation [machines] [workers] [days] [refill_hours] [csv_file]
+ *
+ * refill_hours = 0 (default) disables refills.
+ */
+
+#include "cash_exchange_machine.h"
+#include "refill_planner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct MachineResult
+ * @brief Simulation outcome of one machine.
+ */
+struct MachineResult {
+    double customersPerHour{0};
+    long transactions{0};
+    long partial{0};
+    double depletedAfter{-1};   ///< simulated hours, -1 = never
+    long loaded{0};             ///< notes loaded by refills
+};
+
+/**
+ * @class Shard
+ * @brief A slice of the fleet with its own event clock.
+ */
+class Shard {
+
+private:
+
+    /// (simulated time in hours, local machine index or kRefillRound)
+    using Event = std::pair<double, std::size_t>;
+
+    static constexpr std::size_t kRefillRound = static_cast<std::size_t>(-1);
+
+    std::size_t first_;                    ///< global index of machine 0
+    std::deque<CashExchangeMachine> machines_;
+    std::vector<RefillPlanner> planners_;  ///< one forecast per machine
+    std::vector<double> rates_;            ///< customers per hour
+    std::vector<RefillOrder> orders_;      ///< reused by refill rounds
+    std::vector<MachineResult>& results_;
+    std::mt19937_64 rng_;
+    long events_{0};
+
+    void serve(std::size_t local, double now) {
+        static const int notes[] = {5, 10, 20, 50, 100};
+
+        CashExchangeMachine& machine = machines_[local];
+        RefillPlanner& planner = planners_[local];
+        MachineResult& result = results_[first_ + local];
+
+        int count = 1 + static_cast<int>(rng_() % 3);
+        try {
+            for (int i = 0; i < count; ++i) {
+                int note = notes[rng_() % 5];
+                machine.insertMoney(note);
+                planner.onInsert(note, now);
+            }
+            machine.exchange();
+            planner.onExchange(machine.lastPayout(), now);
+            ++result.transactions;
+        } catch (const std::runtime_error&) {
+            // Partial exchange: the customer cancels and takes the notes back
+            ++result.transactions;
+            ++result.partial;
+            if (result.depletedAfter < 0)
+                result.depletedAfter = now;
+            planner.onPartialExchange(static_cast<int>(machine.getInserted().units()), now);
+            if (machine.tryCancel().ok())
+                planner.onExchange(machine.lastPayout(), now);
+        }
+        ++events_;
+    }
+
+    /**
+     * @brief Operator visit: load what each planner asks for.
+     */
+    void refillAll(double now, double interval) {
+        for (std::size_t i = 0; i < machines_.size(); ++i) {
+            planners_[i].recommend(machines_[i].inventory(), interval, orders_);
+            for (const RefillOrder& o : orders_) {
+                machines_[i].refill(o.denomination, o.count);
+                planners_[i].onRefill(o.denomination, o.count, now);
+                results_[first_ + i].loaded += o.count;
+            }
+        }
+    }
+
+public:
+
+    Shard(std::size_t first, std::size_t count,
+          std::vector<MachineResult>& results, unsigned seed)
+        : first_(first), results_(results), rng_(seed) {
+
+        std::lognormal_distribution<double> rate(std::log(12.0), 0.8);
+        for (std::size_t i = 0; i < count; ++i) {
+            machines_.emplace_back();
+            planners_.emplace_back(machines_.back().profile());
+            rates_.push_back(std::clamp(rate(rng_), 0.5, 240.0));
+            results_[first_ + i].customersPerHour = rates_.back();
+        }
+    }
+
+    /**
+     * @brief Run every machine of the shard until `hours`.
+     * @param refillEvery hours between operator visits (0 = never)
+     */
+    void run(double hours, double refillEvery) {
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> clock;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        auto nextArrival = [&](std::size_t local, double now) {
+            return now - std::log(1.0 - unit(rng_)) / rates_[local];
+        };
+
+        for (std::size_t i = 0; i < machines_.size(); ++i)
+            clock.push({nextArrival(i, 0.0), i});
+        if (refillEvery > 0.0)
+            clock.push({refillEvery, kRefillRound});
+
+        while (!clock.empty()) {
+            auto [now, local] = clock.top();
+            clock.pop();
+            if (now > hours)
+                continue;
+
+            if (local == kRefillRound) {
+                refillAll(now, refillEvery);
+                clock.push({now + refillEvery, kRefillRound});
+                continue;
+            }
+
+            serve(local, now);
+            clock.push({nextArrival(local, now), local});
+        }
+    }
+
+    long events() const {
+        return events_;
+    }
+};
+
+/**
+ * @brief q-quantile of a sorted vector.
+ */
+double quantile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty())
+        return 0.0;
+    return sorted[static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1))];
+}
+
+int main(int argc, char* argv[]) {
+
+    unsigned hw = std::thread::hardware_concurrency();
+    std::size_t machines = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10'000;
+    std::size_t workers = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : (hw ? hw : 4);
+    double days = (argc > 3) ? std::atof(argv[3]) : 1.0;
+    double refillHours = (argc > 4) ? std::atof(argv[4]) : 0.0;
+    const char* csv = (argc > 5) ? argv[5] : nullptr;
+
+    if (machines == 0) {
+        std::cerr << "[ERROR] The fleet needs at least one machine.\n";
+        return 1;
+    }
+    workers = std::max<std::size_t>(1, std::min(workers, machines));
+    const double hours = days * 24.0;
+
+    std::vector<MachineResult> results(machines);
+    std::vector<long> events(workers, 0);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (std::size_t w = 0; w < workers; ++w) {
+        std::size_t first = machines * w / workers;
+        std::size_t last = machines * (w + 1) / workers;
+
+        pool.emplace_back([&, w, first, last] {
+            Shard shard(first, last - first, results, static_cast<unsigned>(w) + 1);
+            shard.run(hours, refillHours);
+            events[w] = shard.events();
+        });
+    }
+    for (std::thread& t : pool)
+        t.join();
+
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    long totalEvents = 0;
+    for (long e : events)
+        totalEvents += e;
+
+    std::vector<double> depletion;
+    double partialRate = 0.0;
+    long loaded = 0;
+    for (const MachineResult& r : results) {
+        loaded += r.loaded;
+        if (r.depletedAfter >= 0)
+            depletion.push_back(r.depletedAfter);
+        if (r.transactions > 0)
+            partialRate += static_cast<double>(r.partial) / static_cast<double>(r.transactions);
+    }
+    std::sort(depletion.begin(), depletion.end());
+    if (!results.empty())
+        partialRate /= static_cast<double>(results.size());
+
+    std::cout << "Fleet: " << machines << " machines, " << workers << " workers, "
+              << days << " simulated days\n"
+              << "Wall time: " << wall.count() << " s ("
+              << static_cast<long>(hours * 3600.0 / wall.count()) << "x real time)\n"
+              << "Transactions: " << totalEvents << " ("
+              << static_cast<long>(static_cast<double>(totalEvents) / wall.count())
+              << " per second)\n"
+              << "Depleted machines: " << depletion.size() << " ("
+              << 100.0 * static_cast<double>(depletion.size()) / static_cast<double>(machines)
+              << " %)\n"
+              << "Depleted after (hours): p10 " << quantile(depletion, 0.10)
+              << ", p50 " << quantile(depletion, 0.50)
+              << ", p90 " << quantile(depletion, 0.90) << "\n"
+              << "Average partial-exchange rate: " << 100.0 * partialRate << " %\n"
+              << "Refills: every " << refillHours << " h, " << loaded << " notes loaded\n";
+
+    if (csv) {
+        std::ofstream out(csv);
+        out << "machine,customers_per_hour,transactions,partial,depleted_after_h,notes_loaded\n";
+        for (std::size_t i = 0; i < machines; ++i) {
+            const MachineResult& r = results[i];
+            out << i << ',' << r.customersPerHour << ',' << r.transactions << ','
+                << r.partial << ',' << r.depletedAfter << ',' << r.loaded << '\n';
+        }
+        std::cout << "Per-machine results written to " << csv << "\n";
+    }
+
+    return 0;
+}
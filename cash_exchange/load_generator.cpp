@@ -0,0 +1,271 @@
+/**
+ * @file load_generator.cpp
+ * @brief Headless load generator and throughput benchmark.
+ *
+ * @details
+ * Replays insert/exchange/refill traces against one CashExchangeMachine
+ * at full speed and reports:
+ *
+ * - operations and exchanges per second
+ * - p50 / p99 / p999 latency per operation type
+ * - heap allocations during the replay (global operator new is counted)
+ * - rejected inserts and partial exchanges (cancelled: the notes are
+ *   refunded, or stay inserted if even that is impossible)
+ *
+ * Traces are generated up front (not timed) or read from a file:
+ *
+ * - uniform : 1-3 random notes per transaction, every denomination alike
+ * - skewed  : mostly 20/50 notes, as at a busy till
+ * - starved : 50/100 notes only and no refills, the pool runs dry
+ * - trace   : recorded file, one op per line: "I <note>", "E", "R <note> <count>"
+ *
+ * @usage
+ * g++ -std=c++17 -O2 load_generator.cpp -o load_generator
+ * ./load_generator [uniform|skewed|starved|all] [operations]
+ * ./load_generator trace <file>
+ */
+
+#include "cash_exchange_machine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* ============================================================
+   ALLOCATION COUNTER
+   Every global operator new goes through here.
+   ============================================================ */
+
+static std::atomic<long> gAllocations{0};
+
+void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/* ============================================================
+   TRACES
+   ============================================================ */
+
+/**
+ * @struct Op
+ * @brief One replayed event.
+ */
+struct Op {
+    enum Type : std::uint8_t { Insert, Exchange, Refill } type;
+    int value;   ///< note (insert/refill)
+    int count;   ///< notes (refill)
+};
+
+enum class Mix { Uniform, Skewed, Starved };
+
+/**
+ * @brief Synthetic trace of roughly `operations` events.
+ */
+std::vector<Op> generate(Mix mix, long operations, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::vector<Op> ops;
+    ops.reserve(static_cast<std::size_t>(operations) + 8);
+
+    const int uniform[] = {5, 10, 20, 50, 100};
+    const int skewed[] = {20, 20, 20, 50, 50, 50, 10, 5, 100};
+    const int starved[] = {50, 100, 100};
+
+    while (static_cast<long>(ops.size()) < operations) {
+        int notes = 1 + static_cast<int>(rng() % 3);
+        for (int i = 0; i < notes; ++i) {
+            int note = 0;
+            switch (mix) {
+            case Mix::Uniform: note = uniform[rng() % 5]; break;
+            case Mix::Skewed:  note = skewed[rng() % 9]; break;
+            case Mix::Starved: note = starved[rng() % 3]; break;
+            }
+            ops.push_back({Op::Insert, note, 0});
+        }
+        ops.push_back({Op::Exchange, 0, 0});
+
+        // Operators top up small notes now and then, except when starved
+        if (mix != Mix::Starved && rng() % 64 == 0)
+            ops.push_back({Op::Refill, uniform[rng() % 4], 20});
+    }
+    return ops;
+}
+
+/**
+ * @brief Recorded trace from a file.
+ */
+std::vector<Op> load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("Cannot open trace " + path + ".");
+
+    std::vector<Op> ops;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        std::istringstream fields(line);
+        char type = 0;
+        if (!(fields >> type))
+            continue;   // blank line
+
+        Op op{Op::Exchange, 0, 0};
+        if (type == 'I') {
+            op.type = Op::Insert;
+            fields >> op.value;
+        } else if (type == 'R') {
+            op.type = Op::Refill;
+            fields >> op.value >> op.count;
+        } else if (type != 'E') {
+            throw std::runtime_error("Bad trace op '" + std::string(1, type) +
+                                     "' on line " + std::to_string(lineNo) + ".");
+        }
+        std::string rest;
+        if (fields.fail() || fields >> rest)
+            throw std::runtime_error("Bad trace line " + std::to_string(lineNo) + ".");
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+/* ============================================================
+   REPLAY
+   ============================================================ */
+
+/**
+ * @struct Latencies
+ * @brief Per-operation latency samples (ns), preallocated.
+ */
+struct Latencies {
+    std::vector<std::uint32_t> samples;
+
+    void print(const char* name) {
+        if (samples.empty())
+            return;
+        auto at = [this](double q) {
+            std::size_t k = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+            std::nth_element(samples.begin(), samples.begin() + static_cast<long>(k), samples.end());
+            return samples[k];
+        };
+        std::cout << "  " << std::left << std::setw(9) << name << std::right
+                  << " n=" << std::setw(9) << samples.size()
+                  << "  p50=" << std::setw(6) << at(0.50) << " ns"
+                  << "  p99=" << std::setw(6) << at(0.99) << " ns"
+                  << "  p999=" << std::setw(6) << at(0.999) << " ns\n";
+    }
+};
+
+void replay(const std::string& name, const std::vector<Op>& ops) {
+    CashExchangeMachine machine;
+
+    Latencies inserts, exchanges, refills;
+    inserts.samples.reserve(ops.size());
+    exchanges.samples.reserve(ops.size());
+    refills.samples.reserve(ops.size());
+
+    long rejected = 0;
+    long partial = 0;
+    long unrefunded = 0;
+
+    using Clock = std::chrono::steady_clock;
+    const long allocationsBefore = gAllocations.load();
+    const auto start = Clock::now();
+
+    for (const Op& op : ops) {
+        const auto t0 = Clock::now();
+        Latencies* bucket = &inserts;
+
+        try {
+            switch (op.type) {
+            case Op::Insert:
+                machine.insertMoney(op.value);
+                break;
+            case Op::Exchange:
+                bucket = &exchanges;
+                machine.exchange();
+                break;
+            case Op::Refill:
+                bucket = &refills;
+                machine.refill(op.value, op.count);
+                break;
+            }
+        } catch (const std::invalid_argument&) {
+            ++rejected;
+        } catch (const std::runtime_error&) {
+            // Customer cancels and takes the notes back
+            ++partial;
+            if (!machine.tryCancel().ok())
+                ++unrefunded;
+        }
+
+        bucket->samples.push_back(static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count()));
+    }
+
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    const long allocations = gAllocations.load() - allocationsBefore;
+
+    std::cout << name << ": " << ops.size() << " ops in " << elapsed.count() << " s\n"
+              << "  " << static_cast<long>(static_cast<double>(ops.size()) / elapsed.count())
+              << " ops/s, "
+              << static_cast<long>(static_cast<double>(exchanges.samples.size()) / elapsed.count())
+              << " exchanges/s\n"
+              << "  allocations: " << allocations
+              << ", rejected inserts: " << rejected
+              << ", partial exchanges: " << partial
+              << " (" << unrefunded << " not refunded)\n";
+
+    inserts.print("insert");
+    exchanges.print("exchange");
+    refills.print("refill");
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string mode = (argc > 1) ? argv[1] : "all";
+
+    try {
+        if (mode == "trace") {
+            if (argc < 3)
+                throw std::invalid_argument("trace mode needs a file.");
+            replay(argv[2], load(argv[2]));
+            return 0;
+        }
+
+        long operations = (argc > 2) ? std::atol(argv[2]) : 2'000'000L;
+
+        if (mode == "uniform" || mode == "all")
+            replay("uniform", generate(Mix::Uniform, operations));
+        if (mode == "skewed" || mode == "all")
+            replay("skewed", generate(Mix::Skewed, operations));
+        if (mode == "starved" || mode == "all")
+            replay("starved", generate(Mix::Starved, operations));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[EXCEPTION] " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
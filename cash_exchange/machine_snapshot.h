@@ -0,0 +1,183 @@
+/**
+ * @file machine_snapshot.h
+ * @brief Compact, versioned binary snapshot of one exchange machine.
+ */
+#pragma once
+
+#include "cash_exchange_machine.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/* ============================================================
+   MACHINE SNAPSHOT
+   Concept: Fixed binary layout, caller-owned buffers
+   ============================================================ */
+
+/**
+ * @class MachineSnapshot
+ * @brief serialize()/deserialize() a machine to/from raw bytes.
+ *
+ * Layout (little-endian, 28 + 8 x slots bytes - 68 for EUR):
+ *
+ *   offset  size  field
+ *        0     4  magic "CXSN"
+ *        4     2  format version
+ *        6     1  slots (denominations of the currency profile)
+ *        7     1  state (0 = Idle, 1 = HasMoney)
+ *        8     8  currency code, zero padded
+ *       16     8  inserted amount in cents (signed)
+ *       24  4 x n note counts per slot (signed)
+ *   24+4n  4 x n inserted notes per slot (signed; what a cancel returns)
+ *   24+8n      4  FNV-1a checksum of all bytes before it
+ *
+ * Both directions work on caller-provided buffers: no iostreams, no
+ * allocation per field or per machine, so a whole fleet can be
+ * written into one contiguous buffer.
+ *
+ * deserialize() is meant for a machine that owns its inventory; it
+ * overwrites the counts, the inserted notes and the state.
+ */
+class MachineSnapshot {
+
+public:
+
+    static constexpr std::uint16_t kVersion = 2;
+    static constexpr std::size_t kHeaderSize = 24;
+    static constexpr std::size_t kMaxSize = kHeaderSize + 8 * kMaxDenominations + 4;
+
+private:
+
+    static constexpr unsigned char kMagic[4] = {'C', 'X', 'S', 'N'};
+
+    static unsigned char* put(unsigned char* out, std::uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i)
+            *out++ = static_cast<unsigned char>(v >> (8 * i));
+        return out;
+    }
+
+    static std::uint64_t get(const unsigned char* in, int bytes) {
+        std::uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i)
+            v |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+        return v;
+    }
+
+    static std::uint32_t checksum(const unsigned char* data, std::size_t size) {
+        std::uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+public:
+
+    /**
+     * @brief Bytes of a snapshot for machines of this profile.
+     */
+    static std::size_t size(const CurrencyProfile& profile) {
+        return kHeaderSize + 8 * profile.size() + 4;
+    }
+
+    /**
+     * @brief Write the snapshot of `machine` to `out`.
+     * @return bytes written
+     */
+    static std::size_t serialize(const CashExchangeMachine& machine,
+                                 unsigned char* out, std::size_t capacity) {
+        const CurrencyProfile& profile = machine.profile();
+        const std::size_t bytes = size(profile);
+        if (capacity < bytes)
+            throw std::length_error("Snapshot buffer too small.");
+
+        unsigned char* p = out;
+        std::memcpy(p, kMagic, 4);
+        p = put(p + 4, kVersion, 2);
+        p = put(p, profile.size(), 1);
+        p = put(p, machine.hasMoney() ? 1 : 0, 1);
+
+        std::memset(p, 0, 8);
+        std::memcpy(p, profile.code().data(), std::min<std::size_t>(profile.code().size(), 8));
+        p += 8;
+
+        p = put(p, static_cast<std::uint64_t>(machine.getInserted().cents()), 8);
+        for (std::size_t i = 0; i < profile.size(); ++i)
+            p = put(p, static_cast<std::uint32_t>(machine.inventory().countAt(i)), 4);
+        for (std::size_t i = 0; i < profile.size(); ++i)
+            p = put(p, static_cast<std::uint32_t>(machine.insertedNotes()[i]), 4);
+
+        p = put(p, checksum(out, static_cast<std::size_t>(p - out)), 4);
+        return bytes;
+    }
+
+    /**
+     * @brief Restore `machine` from a snapshot written by serialize().
+     * @return bytes consumed
+     *
+     * Throws std::runtime_error for a damaged snapshot, another format
+     * version or another currency, and for one that is inconsistent:
+     * negative counts, or an inserted amount that is negative, over the
+     * insert limit, not the sum of the inserted notes or at odds with
+     * the state. The machine is untouched then.
+     */
+    static std::size_t deserialize(CashExchangeMachine& machine,
+                                   const unsigned char* in, std::size_t available) {
+        const CurrencyProfile& profile = machine.profile();
+        const std::size_t bytes = size(profile);
+
+        if (available < kHeaderSize || std::memcmp(in, kMagic, 4) != 0)
+            throw std::runtime_error("Not a machine snapshot.");
+        if (get(in + 4, 2) != kVersion)
+            throw std::runtime_error("Unsupported snapshot version " +
+                                     std::to_string(get(in + 4, 2)) + ".");
+        if (get(in + 6, 1) != profile.size() || available < bytes)
+            throw std::runtime_error("Snapshot does not match the currency profile.");
+        if (get(in + bytes - 4, 4) != checksum(in, bytes - 4))
+            throw std::runtime_error("Snapshot checksum mismatch.");
+
+        char code[9] = {};
+        std::memcpy(code, in + 8, 8);
+        if (profile.code() != code)
+            throw std::runtime_error("Snapshot is for currency " + std::string(code) + ".");
+
+        const std::size_t slots = profile.size();
+        const unsigned char* notesIn = in + kHeaderSize + 4 * slots;
+        const std::int64_t inserted = static_cast<std::int64_t>(get(in + 16, 8));
+        const std::int64_t limit = Money::fromUnits(profile.limit()).cents();
+        const std::uint64_t state = get(in + 7, 1);
+
+        // Check every field before changing anything
+        if (inserted < 0 || inserted > limit)
+            throw std::runtime_error("Snapshot inserted amount is out of range.");
+        if (state > 1 || (state == 1) != (inserted > 0))
+            throw std::runtime_error("Snapshot state does not match the inserted amount.");
+
+        std::array<int, kMaxDenominations> notes{};
+        std::int64_t noteSum = 0;
+        for (std::size_t i = 0; i < slots; ++i) {
+            notes[i] = static_cast<std::int32_t>(get(notesIn + 4 * i, 4));
+            if (static_cast<std::int32_t>(get(in + kHeaderSize + 4 * i, 4)) < 0 || notes[i] < 0)
+                throw std::runtime_error("Snapshot holds a negative count.");
+            if (notes[i] > profile.limit() / profile.value(i))
+                throw std::runtime_error("Snapshot inserted amount is out of range.");
+            noteSum += Money::fromUnits(profile.value(i)).cents() * notes[i];
+        }
+        if (noteSum != inserted)
+            throw std::runtime_error("Snapshot inserted amount does not match its notes.");
+
+        for (std::size_t i = 0; i < profile.size(); ++i) {
+            const int count = static_cast<std::int32_t>(get(in + kHeaderSize + 4 * i, 4));
+            machine.inventory().setCount(profile.value(i), count);
+        }
+
+        machine.restoreInserted(notes);
+        return bytes;
+    }
+};
@@ -0,0 +1,236 @@
+/**
+ * @file machine_telemetry.h
+ * @brief Low-overhead per-machine counters and exchange latency histogram.
+ */
+#pragma once
+
+#include "currency_profile.h"
+#include "payout_plan.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+/* ============================================================
+   MACHINE TELEMETRY
+   Concept: Lock-free counters, formatting only on request
+   ============================================================ */
+
+/**
+ * @class MachineTelemetry
+ * @brief What one machine did, counted instead of printed.
+ *
+ * Counters are relaxed atomics written by the single thread that drives
+ * the machine (load + store, no locked read-modify-write). Any other
+ * thread may read them at any time - e.g. a monitoring thread taking a
+ * dump - without stopping the machine.
+ *
+ * Exchange latencies go into a log2 histogram: bucket b counts
+ * exchanges that took [2^(b-1), 2^b) nanoseconds.
+ *
+ * Exports:
+ * - writeText()   → compact "key value" lines (one per non-zero counter)
+ * - writeBinary() → fixed little-endian record of all counters
+ * - print()       → human-readable report
+ */
+class MachineTelemetry {
+
+public:
+
+    static constexpr std::size_t kLatencyBuckets = 32;
+
+    /// Version of the writeBinary() layout
+    static constexpr std::uint32_t kBinaryVersion = 2;
+
+    /// Bytes written by writeBinary()
+    static constexpr std::size_t kBinarySize =
+        8 + 8 * (6 + 2 * kMaxDenominations + kLatencyBuckets);
+
+private:
+
+    using Counter = std::atomic<std::uint64_t>;
+
+    Counter exchanges_{0};          ///< successful exchanges
+    Counter partialExchanges_{0};   ///< exchanges without a valid payout
+    Counter invalidInserts_{0};     ///< unknown denomination
+    Counter limitInserts_{0};       ///< over the insert limit
+    Counter idleExchanges_{0};      ///< exchange with nothing inserted
+    Counter refunds_{0};            ///< cancelled transactions paid back
+
+    std::array<Counter, kMaxDenominations> accepted_{};   ///< notes in, per slot
+    std::array<Counter, kMaxDenominations> dispensed_{};  ///< notes out, per slot
+    std::array<Counter, kLatencyBuckets> latency_{};
+
+    /// Single-writer increment: plain load + store, still race-free to read
+    static void bump(Counter& c, std::uint64_t n = 1) {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static std::uint64_t get(const Counter& c) {
+        return c.load(std::memory_order_relaxed);
+    }
+
+    static std::size_t bucketOf(std::uint64_t ns) {
+        std::size_t b = 0;
+        while (ns && b + 1 < kLatencyBuckets) {
+            ns >>= 1;
+            ++b;
+        }
+        return b;
+    }
+
+    static unsigned char* put(unsigned char* out, std::uint64_t v) {
+        for (int i = 0; i < 8; ++i)
+            *out++ = static_cast<unsigned char>(v >> (8 * i));
+        return out;
+    }
+
+public:
+
+    /* ---------- recording (machine thread only) ---------- */
+
+    void recordInsert(int slot) {
+        bump(accepted_[static_cast<std::size_t>(slot)]);
+    }
+
+    void recordInvalidInsert() {
+        bump(invalidInserts_);
+    }
+
+    void recordLimitInsert() {
+        bump(limitInserts_);
+    }
+
+    void recordIdleExchange() {
+        bump(idleExchanges_);
+    }
+
+    void recordExchange(const CurrencyProfile& profile,
+                        const PayoutPlan& plan,
+                        std::uint64_t ns) {
+        bump(exchanges_);
+        for (const PayoutEntry& e : plan)
+            bump(dispensed_[static_cast<std::size_t>(profile.slotOf(e.denomination))],
+                 static_cast<std::uint64_t>(e.count));
+        bump(latency_[bucketOf(ns)]);
+    }
+
+    void recordRefund(const CurrencyProfile& profile, const PayoutPlan& plan) {
+        bump(refunds_);
+        for (const PayoutEntry& e : plan)
+            bump(dispensed_[static_cast<std::size_t>(profile.slotOf(e.denomination))],
+                 static_cast<std::uint64_t>(e.count));
+    }
+
+    void recordPartialExchange(std::uint64_t ns) {
+        bump(partialExchanges_);
+        bump(latency_[bucketOf(ns)]);
+    }
+
+    /* ---------- reading (any thread) ---------- */
+
+    std::uint64_t exchanges() const { return get(exchanges_); }
+    std::uint64_t partialExchanges() const { return get(partialExchanges_); }
+    std::uint64_t refunds() const { return get(refunds_); }
+    std::uint64_t rejectedInserts() const { return get(invalidInserts_) + get(limitInserts_); }
+
+    std::uint64_t dispensed(std::size_t slot) const { return get(dispensed_[slot]); }
+    std::uint64_t accepted(std::size_t slot) const { return get(accepted_[slot]); }
+
+    /**
+     * @brief Upper bound (ns) of the bucket holding the q-quantile.
+     */
+    std::uint64_t latencyQuantile(double q) const {
+        std::uint64_t total = 0;
+        for (const Counter& c : latency_)
+            total += get(c);
+        if (total == 0)
+            return 0;
+
+        const double target = q * static_cast<double>(total);
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < kLatencyBuckets; ++b) {
+            seen += get(latency_[b]);
+            if (static_cast<double>(seen) >= target)
+                return std::uint64_t{1} << b;
+        }
+        return std::uint64_t{1} << (kLatencyBuckets - 1);
+    }
+
+    /**
+     * @brief Compact text dump: "key value" per non-zero counter.
+     */
+    void writeText(std::ostream& out, const CurrencyProfile& profile) const {
+        auto line = [&out](const char* key, std::uint64_t v) {
+            if (v)
+                out << key << ' ' << v << '\n';
+        };
+        line("exchanges", get(exchanges_));
+        line("partial_exchanges", get(partialExchanges_));
+        line("invalid_inserts", get(invalidInserts_));
+        line("limit_inserts", get(limitInserts_));
+        line("idle_exchanges", get(idleExchanges_));
+        line("refunds", get(refunds_));
+        for (std::size_t i = 0; i < profile.size(); ++i) {
+            if (get(accepted_[i]))
+                out << "accepted." << profile.value(i) << ' ' << get(accepted_[i]) << '\n';
+            if (get(dispensed_[i]))
+                out << "dispensed." << profile.value(i) << ' ' << get(dispensed_[i]) << '\n';
+        }
+        for (std::size_t b = 0; b < kLatencyBuckets; ++b)
+            if (get(latency_[b]))
+                out << "latency_le_ns." << (std::uint64_t{1} << b) << ' ' << get(latency_[b]) << '\n';
+    }
+
+    /**
+     * @brief Binary dump, kBinarySize bytes, little-endian.
+     *
+     * Layout: u32 version, u32 slots, then u64 counters: exchanges,
+     * partial, invalid, limit, idle, refunds, accepted[16], dispensed[16],
+     * latency[32].
+     */
+    std::size_t writeBinary(unsigned char* out, std::size_t slots) const {
+        unsigned char* p = out;
+        std::uint64_t head = kBinaryVersion | (static_cast<std::uint64_t>(slots) << 32);
+        p = put(p, head);
+        p = put(p, get(exchanges_));
+        p = put(p, get(partialExchanges_));
+        p = put(p, get(invalidInserts_));
+        p = put(p, get(limitInserts_));
+        p = put(p, get(idleExchanges_));
+        p = put(p, get(refunds_));
+        for (const Counter& c : accepted_)
+            p = put(p, get(c));
+        for (const Counter& c : dispensed_)
+            p = put(p, get(c));
+        for (const Counter& c : latency_)
+            p = put(p, get(c));
+        return static_cast<std::size_t>(p - out);
+    }
+
+    /**
+     * @brief Human-readable report.
+     */
+    void print(std::ostream& out, const CurrencyProfile& profile) const {
+        out << "\nTelemetry:\n"
+            << "Exchanges: " << get(exchanges_)
+            << " (partial: " << get(partialExchanges_)
+            << ", refunded: " << get(refunds_) << ")\n"
+            << "Rejected inserts: " << get(invalidInserts_) << " invalid, "
+            << get(limitInserts_) << " over limit\n";
+        for (std::size_t i = 0; i < profile.size(); ++i)
+            out << profile.value(i) << " " << profile.code()
+                << " : in " << get(accepted_[i])
+                << ", out " << get(dispensed_[i]) << "\n";
+        out << "Exchange latency: p50 <= " << latencyQuantile(0.50)
+            << " ns, p99 <= " << latencyQuantile(0.99) << " ns\n";
+    }
+};
+
+// Counters are the only members, and writeBinary() writes each of them
+// once after the 8-byte head: a new counter must be added there too.
+static_assert(MachineTelemetry::kBinarySize == 8 + sizeof(MachineTelemetry),
+              "writeBinary() exports every counter");
@@ -0,0 +1,103 @@
+/**
+ * @file payout_plan.h
+ * @brief Read-only payout plan: which notes an exchange will dispense.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/* ============================================================
+   PAYOUT PLAN
+   OOP Concept Applied: Encapsulation + Value semantics
+   ============================================================ */
+
+/**
+ * @struct PayoutEntry
+ * @brief `count` notes of `denomination`.
+ */
+struct PayoutEntry {
+    int denomination;
+    int count;
+};
+
+/**
+ * @class PayoutPlan
+ * @brief Complete payout, computed before the inventory is touched.
+ *
+ * A change maker fills the plan read-only; CashInventory::apply()
+ * then commits it in one step. Each denomination appears at most
+ * once, so committing costs one bounds check per denomination.
+ *
+ * clear() keeps the capacity, so a plan owned by the machine is
+ * reused across exchanges without allocating.
+ */
+class PayoutPlan {
+private:
+
+    std::vector<PayoutEntry> entries_;
+    int total_{0};
+
+public:
+
+    PayoutPlan() = default;
+
+    /**
+     * @brief Reserve room for `denominations` entries up front.
+     */
+    explicit PayoutPlan(std::size_t denominations) {
+        entries_.reserve(denominations);
+    }
+
+    void clear() {
+        entries_.clear();
+        total_ = 0;
+    }
+
+    /**
+     * @brief Append `count` notes of `denomination` (ignored if 0).
+     */
+    void add(int denomination, int count) {
+        if (count <= 0)
+            return;
+        entries_.push_back({denomination, count});
+        total_ += denomination * count;
+    }
+
+    /**
+     * @brief Amount paid out by the plan.
+     */
+    int total() const {
+        return total_;
+    }
+
+    /**
+     * @brief Number of notes paid out by the plan.
+     */
+    int notes() const {
+        int n = 0;
+        for (const PayoutEntry& e : entries_)
+            n += e.count;
+        return n;
+    }
+
+    bool empty() const {
+        return entries_.empty();
+    }
+
+    std::size_t size() const {
+        return entries_.size();
+    }
+
+    const PayoutEntry& operator[](std::size_t i) const {
+        return entries_[i];
+    }
+
+    std::vector<PayoutEntry>::const_iterator begin() const {
+        return entries_.begin();
+    }
+
+    std::vector<PayoutEntry>::const_iterator end() const {
+        return entries_.end();
+    }
+};
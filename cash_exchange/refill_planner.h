@@ -0,0 +1,231 @@
+/**
+ * @file refill_planner.h
+ * @brief Streaming note outflow forecast and refill recommendations.
+ */
+#pragma once
+
+#include "cash_inventory.h"
+#include "currency_profile.h"
+#include "payout_plan.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/* ============================================================
+   REFILL PLANNER
+   Concept: Exponentially weighted rates, updated per transaction
+   ============================================================ */
+
+/**
+ * @struct RefillOrder
+ * @brief Notes an operator should load into one machine.
+ */
+struct RefillOrder {
+    int denomination;
+    int count;
+};
+
+/**
+ * @class RefillPlanner
+ * @brief Forecasts when each note runs out and how many to load.
+ *
+ * Fed incrementally with the events of one machine, stamped with the
+ * caller's clock (any unit - hours in the fleet simulation). Per slot
+ * it keeps an exponentially decayed sum of notes in and notes out, so
+ * memory is constant and every update is O(slots):
+ *
+ *   sum(t) = sum(t0) * exp(-(t - t0) / tau) + notes
+ *   rate   = sum / (tau * (1 - exp(-observed / tau)))
+ *
+ * The denominator is the decayed length of the observed history, so
+ * the rate is unbiased right after start-up too.
+ *
+ * Only notes that really leave count as outflow: a payout, or the
+ * refund of a cancelled transaction (fed through onExchange() too).
+ * Demand a partial exchange could not serve is kept apart as
+ * shortfall - those notes never left - split over the payout notes as
+ * if the machine had them. It only raises the refill target, so the
+ * notes whose shortage caused failures are pushed up.
+ */
+class RefillPlanner {
+
+private:
+
+    const CurrencyProfile* profile_;
+    double tau_;                               ///< averaging time constant
+
+    double start_{std::numeric_limits<double>::quiet_NaN()};
+    double last_{0.0};
+
+    std::array<double, kMaxDenominations> in_{};    ///< decayed notes in
+    std::array<double, kMaxDenominations> out_{};   ///< decayed notes out
+    std::array<double, kMaxDenominations> unmet_{}; ///< decayed notes short
+
+    /**
+     * @brief Decay every sum to `now` (events arrive in time order).
+     */
+    void advance(double now) {
+        if (std::isnan(start_)) {
+            start_ = last_ = now;
+            return;
+        }
+        if (now <= last_)
+            return;
+
+        const double k = std::exp(-(now - last_) / tau_);
+        for (std::size_t i = 0; i < profile_->size(); ++i) {
+            in_[i] *= k;
+            out_[i] *= k;
+            unmet_[i] *= k;
+        }
+        last_ = now;
+    }
+
+    /**
+     * @brief Decayed length of the observed history.
+     */
+    double weight() const {
+        if (std::isnan(start_) || last_ <= start_)
+            return 0.0;
+        return tau_ * (1.0 - std::exp(-(last_ - start_) / tau_));
+    }
+
+    void addOut(int value, double notes) {
+        int slot = profile_->slotOf(value);
+        if (slot >= 0)
+            out_[static_cast<std::size_t>(slot)] += notes;
+    }
+
+public:
+
+    /**
+     * @param profile currency of the machine
+     * @param tau     averaging time constant (same unit as the clock)
+     */
+    explicit RefillPlanner(const CurrencyProfile& profile = CurrencyProfile::eur(),
+                           double tau = 4.0)
+        : profile_(&profile), tau_(tau > 0.0 ? tau : 1.0) {}
+
+    /* ---------- event feed ---------- */
+
+    void onInsert(int value, double now) {
+        advance(now);
+        int slot = profile_->slotOf(value);
+        if (slot >= 0)
+            in_[static_cast<std::size_t>(slot)] += 1.0;
+    }
+
+    void onExchange(const PayoutPlan& plan, double now) {
+        advance(now);
+        for (const PayoutEntry& e : plan)
+            addOut(e.denomination, e.count);
+    }
+
+    /**
+     * @brief A partial exchange of `amount`: demand, not outflow.
+     */
+    void onPartialExchange(int amount, double now) {
+        advance(now);
+        for (int d : profile_->payoutDenominations()) {
+            const int slot = profile_->slotOf(d);
+            if (slot >= 0)
+                unmet_[static_cast<std::size_t>(slot)] += amount / d;
+            amount %= d;
+        }
+    }
+
+    void onRefill(int value, int count, double now) {
+        // Loading notes is not demand - only the clock moves
+        (void)value;
+        (void)count;
+        advance(now);
+    }
+
+    /* ---------- forecast ---------- */
+
+    /**
+     * @brief Notes leaving minus notes arriving, per time unit.
+     */
+    double netOutflow(std::size_t slot) const {
+        const double w = weight();
+        return w > 0.0 ? (out_[slot] - in_[slot]) / w : 0.0;
+    }
+
+    double outflow(std::size_t slot) const {
+        const double w = weight();
+        return w > 0.0 ? out_[slot] / w : 0.0;
+    }
+
+    /**
+     * @brief Notes asked for but not paid, per time unit.
+     */
+    double shortfall(std::size_t slot) const {
+        const double w = weight();
+        return w > 0.0 ? unmet_[slot] / w : 0.0;
+    }
+
+    /**
+     * @brief Time until `count` notes of the slot are gone (inf if never).
+     */
+    double timeToEmpty(std::size_t slot, int count) const {
+        const double rate = netOutflow(slot);
+        if (rate <= 0.0)
+            return std::numeric_limits<double>::infinity();
+        return static_cast<double>(count) / rate;
+    }
+
+    /**
+     * @brief Payout note that runs out first, or -1 if none does.
+     */
+    int firstToEmpty(const CashInventory& inventory, double* when = nullptr) const {
+        int first = -1;
+        double best = std::numeric_limits<double>::infinity();
+        for (int d : profile_->payoutDenominations()) {
+            const std::size_t slot = static_cast<std::size_t>(profile_->slotOf(d));
+            const double t = timeToEmpty(slot, inventory.countAt(slot));
+            if (t < best) {
+                best = t;
+                first = d;
+            }
+        }
+        if (when)
+            *when = best;
+        return first;
+    }
+
+    /**
+     * @brief Notes to load so every payout note lasts `horizon`.
+     *
+     * Target stock = expected net outflow plus shortfall over the
+     * horizon, plus `z` standard deviations of the (Poisson-like) gross
+     * demand, so a burst of customers does not empty a slot before the
+     * next visit.
+     *
+     * @return number of orders written to `orders` (cleared first)
+     */
+    std::size_t recommend(const CashInventory& inventory,
+                          double horizon,
+                          std::vector<RefillOrder>& orders,
+                          double z = 2.0) const {
+        orders.clear();
+        for (int d : profile_->payoutDenominations()) {
+            const std::size_t slot = static_cast<std::size_t>(profile_->slotOf(d));
+            const double demand =
+                std::max(0.0, netOutflow(slot) + shortfall(slot)) * horizon;
+            const double spread = std::sqrt((outflow(slot) + shortfall(slot)) * horizon);
+            const int target = static_cast<int>(std::ceil(demand + z * spread));
+            const int missing = target - inventory.countAt(slot);
+            if (missing > 0)
+                orders.push_back({d, missing});
+        }
+        return orders.size();
+    }
+
+    double tau() const {
+        return tau_;
+    }
+};
@@ -0,0 +1,171 @@
+/**
+ * @file rejection_bench.cpp
+ * @brief Cost of rejected operations: exceptions vs result types.
+ *
+ * @details
+ * Runs each scenario twice on fresh machines - once through the
+ * throwing API (insertMoney/exchange inside try/catch) and once
+ * through the result API (tryInsertMoney/tryExchange) - and reports
+ * nanoseconds per operation:
+ *
+ * - invalid : every insert is an unknown note (7 EUR)
+ * - limit   : every insert would pass the 500 EUR limit
+ * - partial : insert 100 EUR + exchange with an empty pool, every
+ *             exchange fails
+ * - mixed   : realistic traffic where `invalid_share` % of the
+ *             inserts are rejected, the rest are exchanged normally
+ *
+ * @usage
+ * g++ -std=c++17 -O2 rejection_bench.cpp -o rejection_bench
+ * ./rejection_bench [operations] [invalid_share]   (default: 1000000 30)
+ */
+
+#include "cash_exchange_machine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+enum class Mode { Throwing, Result };
+
+/**
+ * @brief One insert, whichever API; true if accepted.
+ */
+bool insert(CashExchangeMachine& m, int note, Mode mode) {
+    if (mode == Mode::Result)
+        return m.tryInsertMoney(note).ok();
+    try {
+        m.insertMoney(note);
+        return true;
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+}
+
+/**
+ * @brief One exchange, whichever API; a failed one is cancelled.
+ */
+bool exchange(CashExchangeMachine& m, Mode mode) {
+    bool ok = true;
+    if (mode == Mode::Result) {
+        // Like the throwing API, an exchange with nothing inserted is no failure
+        ok = m.tryExchange().status != MachineStatus::PartialExchange;
+    } else {
+        try {
+            m.exchange();
+        } catch (const std::runtime_error&) {
+            ok = false;
+        }
+    }
+    if (!ok)
+        m.tryCancel();
+    return ok;
+}
+
+/**
+ * @brief Empty every slot of the machine's pool.
+ */
+void drain(CashExchangeMachine& m) {
+    for (std::size_t i = 0; i < m.profile().size(); ++i)
+        m.inventory().setCount(m.profile().value(i), 0);
+}
+
+/**
+ * @brief ns per operation of one scenario in one mode.
+ */
+double run(const char* scenario, Mode mode, long operations,
+           const std::vector<int>& mixed, long& rejected) {
+    CashExchangeMachine m;
+    rejected = 0;
+
+    if (std::string(scenario) == "limit") {
+        for (int i = 0; i < 5; ++i)
+            m.insertMoney(100);
+    } else if (std::string(scenario) == "partial") {
+        drain(m);
+    }
+
+    auto start = Clock::now();
+
+    if (std::string(scenario) == "invalid") {
+        for (long i = 0; i < operations; ++i)
+            rejected += !insert(m, 7, mode);
+    } else if (std::string(scenario) == "limit") {
+        for (long i = 0; i < operations; ++i)
+            rejected += !insert(m, 5, mode);
+    } else if (std::string(scenario) == "partial") {
+        for (long i = 0; i < operations; i += 2) {
+            insert(m, 100, mode);
+            rejected += !exchange(m, mode);
+        }
+    } else {
+        for (int note : mixed) {
+            if (note > 0) {
+                rejected += !insert(m, note, mode);
+            } else {
+                rejected += !exchange(m, mode);
+                if (note < 0)
+                    m.refill(-note, 20);
+            }
+        }
+        operations = static_cast<long>(mixed.size());
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / static_cast<double>(operations);
+}
+
+/**
+ * @brief Inserts (note > 0) and exchanges (0, or -note to also refill).
+ */
+std::vector<int> mixedTrace(long operations, int invalidShare) {
+    std::mt19937 rng(3);
+    const int valid[] = {5, 10, 20, 50, 100};
+    const int invalid[] = {1, 3, 7, 25, 200};
+
+    std::vector<int> ops;
+    ops.reserve(static_cast<std::size_t>(operations) + 4);
+    while (static_cast<long>(ops.size()) < operations) {
+        int count = 1 + static_cast<int>(rng() % 3);
+        for (int i = 0; i < count; ++i) {
+            bool bad = static_cast<int>(rng() % 100) < invalidShare;
+            ops.push_back(bad ? invalid[rng() % 5] : valid[rng() % 5]);
+        }
+        ops.push_back(rng() % 16 == 0 ? -valid[rng() % 4] : 0);
+    }
+    return ops;
+}
+
+int main(int argc, char* argv[]) {
+
+    long operations = (argc > 1) ? std::atol(argv[1]) : 1'000'000L;
+    int invalidShare = (argc > 2) ? std::atoi(argv[2]) : 30;
+
+    const std::vector<int> mixed = mixedTrace(operations, invalidShare);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "scenario   rejected   throwing ns/op   result ns/op   speed-up\n";
+
+    for (const char* scenario : {"invalid", "limit", "partial", "mixed"}) {
+        long rejectedThrowing = 0;
+        long rejectedResult = 0;
+        double throwing = run(scenario, Mode::Throwing, operations, mixed, rejectedThrowing);
+        double result = run(scenario, Mode::Result, operations, mixed, rejectedResult);
+
+        std::cout << std::left << std::setw(10) << scenario << std::right
+                  << std::setw(9) << rejectedResult
+                  << std::setw(19) << throwing
+                  << std::setw(15) << result
+                  << std::setw(10) << throwing / result << "x"
+                  << (rejectedThrowing == rejectedResult ? "" : "  (MODES DISAGREE)")
+                  << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file snapshot_bench.cpp
+ * @brief Fleet checkpoint/restore time with MachineSnapshot.
+ *
+ * @details
+ * 1. Builds a fleet of machines and gives each a few random
+ *    transactions; every fourth machine is left mid-transaction.
+ * 2. Checkpoint: serializes every machine into one contiguous buffer
+ *    and writes it to a file with a single write() + fsync().
+ * 3. Restore: reads the file back and deserializes it into a fresh
+ *    fleet (as after a restart or on another host).
+ * 4. Checks that both fleets are identical.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 snapshot_bench.cpp -o snapshot_bench
+ * ./snapshot_bench [machines] [file]      (default: 100000 fleet.snap)
+ */
+
+#include "cash_exchange_machine.h"
+#include "machine_snapshot.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void writeFile(const std::string& path, const std::vector<unsigned char>& data) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    std::size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "write " + path);
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    ::fsync(fd);
+    ::close(fd);
+}
+
+std::vector<unsigned char> readFile(const std::string& path, std::size_t size) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    std::vector<unsigned char> data(size);
+    std::size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::read(fd, data.data() + done, size - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Short read from " + path + ".");
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    return data;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t machines = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100'000;
+    std::string path = (argc > 2) ? argv[2] : "fleet.snap";
+
+    try {
+        std::deque<CashExchangeMachine> fleet(machines);
+
+        std::mt19937 rng(11);
+        const int notes[] = {5, 10, 20, 50, 100};
+        for (std::size_t i = 0; i < machines; ++i) {
+            CashExchangeMachine& m = fleet[i];
+            for (int t = 0; t < 4; ++t) {
+                m.insertMoney(notes[rng() % 5]);
+                try {
+                    m.exchange();
+                } catch (const std::runtime_error&) {
+                    m.tryCancel();
+                }
+            }
+            if (i % 4 == 0)
+                m.insertMoney(notes[rng() % 5]);
+        }
+
+        const std::size_t record = MachineSnapshot::size(CurrencyProfile::eur());
+        std::vector<unsigned char> buffer(machines * record);
+
+        // Checkpoint
+        auto start = Clock::now();
+        unsigned char* p = buffer.data();
+        for (const CashExchangeMachine& m : fleet)
+            p += MachineSnapshot::serialize(m, p, record);
+        const double serializeMs = millisSince(start);
+        writeFile(path, buffer);
+        const double checkpointMs = millisSince(start);
+
+        // Restore
+        std::deque<CashExchangeMachine> restored(machines);
+
+        start = Clock::now();
+        const std::vector<unsigned char> data = readFile(path, buffer.size());
+        const unsigned char* q = data.data();
+        const unsigned char* end = data.data() + data.size();
+        for (CashExchangeMachine& m : restored)
+            q += MachineSnapshot::deserialize(m, q, static_cast<std::size_t>(end - q));
+        const double restoreMs = millisSince(start);
+
+        bool same = true;
+        for (std::size_t i = 0; i < machines && same; ++i) {
+            const CashExchangeMachine& a = fleet[i];
+            const CashExchangeMachine& b = restored[i];
+            same = a.hasMoney() == b.hasMoney() && a.getInserted() == b.getInserted();
+            for (std::size_t s = 0; s < a.profile().size(); ++s)
+                same = same && a.inventory().countAt(s) == b.inventory().countAt(s);
+        }
+
+        std::cout << "Machines: " << machines << ", " << record << " bytes each, "
+                  << buffer.size() / 1024 << " KiB total\n"
+                  << "Checkpoint: " << checkpointMs << " ms (serialize "
+                  << serializeMs << " ms, write + fsync " << checkpointMs - serializeMs
+                  << " ms)\n"
+                  << "Restore:    " << restoreMs << " ms\n"
+                  << (same ? "Fleets match." : "FLEET MISMATCH!") << "\n";
+
+        return same ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[EXCEPTION] " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * @file state_transition_bench.cpp
+ * @brief Microbenchmark: heap-allocated vs preallocated state objects.
+ *
+ * @details
+ * Replays the same event stream (insert 5 EUR, exchange, insert 5 EUR,
+ * exchange, ...) against two machines:
+ *
+ * - "before": a replica of the original context that swaps states with
+ *   setState(std::make_unique<...>()) on every transition
+ * - "after":  CashExchangeMachine, whose states are preallocated members
+ *
+ * Both machines share CashInventory, the cached payout strategy and
+ * MachineTelemetry and print nothing while running, so the difference
+ * is the transition cost.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 state_transition_bench.cpp -o state_transition_bench
+ * ./state_transition_bench [events]      (default: 10000000)
+ */
+
+#include "cash_exchange_machine.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+/* ============================================================
+   BASELINE REPLICA
+   One heap allocation per transition, as before.
+   ============================================================ */
+
+class HeapStateMachine {
+
+public:
+
+    class State {
+    public:
+        virtual ~State() = default;
+        virtual void insertMoney(int amount) = 0;
+        virtual void exchange() = 0;
+    };
+
+private:
+
+    int insertedAmount_{0};
+    CashInventory inventory_;
+    std::unique_ptr<State> state_;
+    CachedChangeMaker changeMaker_{
+        std::make_unique<OptimalChangeMaker>(std::vector<int>{50, 20, 10, 5}), 500, 5};
+    PayoutPlan plan_{kMaxDenominations};
+    MachineTelemetry telemetry_;
+
+    class Idle : public State {
+        HeapStateMachine& m_;
+    public:
+        explicit Idle(HeapStateMachine& m) : m_(m) {}
+        void insertMoney(int amount) override {
+            m_.accept(amount);
+            m_.state_ = std::make_unique<HasMoney>(m_);
+        }
+        void exchange() override {}
+    };
+
+    class HasMoney : public State {
+        HeapStateMachine& m_;
+    public:
+        explicit HasMoney(HeapStateMachine& m) : m_(m) {}
+        void insertMoney(int amount) override {
+            m_.accept(amount);
+        }
+        void exchange() override {
+            m_.dispense();
+            m_.state_ = std::make_unique<Idle>(m_);
+        }
+    };
+
+    void accept(int amount) {
+        if (amount != 5 && amount != 10 &&
+            amount != 20 && amount != 50 &&
+            amount != 100)
+            throw std::invalid_argument("Invalid denomination.");
+        if (insertedAmount_ + amount > 500)
+            throw std::invalid_argument("Insert limit exceeded (max 500 EUR).");
+        insertedAmount_ += amount;
+        inventory_.add(amount);
+        telemetry_.recordInsert(inventory_.profile().slotOf(amount));
+    }
+
+    void dispense() {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        if (!changeMaker_.makeChange(insertedAmount_, inventory_, plan_))
+            throw std::runtime_error("Partial exchange - denominations unavailable.");
+        inventory_.apply(plan_);
+        insertedAmount_ = 0;
+        telemetry_.recordExchange(inventory_.profile(), plan_, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+    }
+
+public:
+
+    HeapStateMachine() : state_(std::make_unique<Idle>(*this)) {}
+
+    void insertMoney(int amount) { state_->insertMoney(amount); }
+    void exchange() { state_->exchange(); }
+};
+
+/* ============================================================
+   BENCHMARK DRIVER
+   ============================================================ */
+
+/**
+ * @brief Runs `events` alternating insert/exchange events.
+ * @return events per second
+ */
+template <typename Machine>
+double run(Machine& machine, long events) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (long i = 0; i < events; i += 2) {
+        machine.insertMoney(5);
+        machine.exchange();
+    }
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(events) / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+
+    long events = (argc > 1) ? std::atol(argv[1]) : 10'000'000L;
+
+    HeapStateMachine before;
+
+    CashExchangeMachine after;
+
+    // Warm up caches and the change maker scratch buffers
+    run(before, 100'000);
+    run(after, 100'000);
+
+    double beforeRate = run(before, events);
+    double afterRate = run(after, events);
+
+    std::cout << "Events: " << events << "\n"
+              << "before (make_unique per transition): "
+              << static_cast<long>(beforeRate) << " events/s\n"
+              << "after  (preallocated states):        "
+              << static_cast<long>(afterRate) << " events/s\n"
+              << "speed-up: " << afterRate / beforeRate << "x\n";
+
+    return 0;
+}
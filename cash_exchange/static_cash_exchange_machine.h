@@ -0,0 +1,332 @@
+/**
+ * @file static_cash_exchange_machine.h
+ * @brief Exchange machine specialized at compile time for one note set.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* ============================================================
+   COMPILE-TIME NOTE SET
+   Concept: Templates + constexpr (no tables built at run time)
+   ============================================================ */
+
+/**
+ * @class StaticCashInventory
+ * @brief Note counts for a denomination pack fixed at build time.
+ *
+ * Notes must be positive and strictly ascending (checked by the
+ * compiler). The value → slot mapping is a fold over the pack, so a
+ * lookup with a constant value folds away completely and a runtime
+ * value costs a handful of compares, no table load.
+ *
+ * Counts are plain ints: a static inventory belongs to one terminal.
+ * Use CashInventory for a pool shared between threads.
+ */
+template <int... Notes>
+class StaticCashInventory {
+
+public:
+
+    static constexpr std::size_t kSize = sizeof...(Notes);
+    static constexpr std::array<int, kSize> kValues{Notes...};
+
+private:
+
+    static constexpr bool ascending() {
+        for (std::size_t i = 0; i < kSize; ++i) {
+            if (kValues[i] <= 0 || (i > 0 && kValues[i] <= kValues[i - 1]))
+                return false;
+        }
+        return true;
+    }
+
+    static_assert(kSize >= 2, "Need at least one note to pay out with.");
+    static_assert(ascending(), "Notes must be positive and strictly ascending.");
+
+    std::array<int, kSize> counts_{};
+
+public:
+
+    /**
+     * @brief Slot of a value, or -1 if it is not a denomination.
+     */
+    static constexpr int slotOf(int value) {
+        int slot = -1;
+        int i = 0;
+        ((value == Notes ? (slot = i) : 0, ++i), ...);
+        return slot;
+    }
+
+    static constexpr bool accepts(int value) {
+        return ((value == Notes) || ...);
+    }
+
+    StaticCashInventory() = default;
+
+    explicit StaticCashInventory(const std::array<int, kSize>& stock)
+        : counts_(stock) {}
+
+    int countAt(std::size_t slot) const {
+        return counts_[slot];
+    }
+
+    int count(int value) const {
+        int slot = slotOf(value);
+        return slot >= 0 ? counts_[static_cast<std::size_t>(slot)] : 0;
+    }
+
+    void addAt(std::size_t slot, int n = 1) {
+        counts_[slot] += n;
+    }
+
+    void removeAt(std::size_t slot, int n) {
+        counts_[slot] -= n;
+    }
+
+    void refill(int value, int n) {
+        if (!accepts(value))
+            throw std::invalid_argument("Unknown denomination.");
+        if (n < 0)
+            throw std::invalid_argument("Refill count must not be negative.");
+        counts_[static_cast<std::size_t>(slotOf(value))] += n;
+    }
+};
+
+/* ============================================================
+   COMPILE-TIME SPECIALIZED MACHINE
+   ============================================================ */
+
+/**
+ * @class StaticCashExchangeMachine
+ * @brief Same behavior as CashExchangeMachine, note set fixed at build time.
+ *
+ * Accepts every note of the pack and pays out with all but the
+ * largest, e.g. StaticCashExchangeMachine<5, 10, 20, 50, 100> takes
+ * 5..100 EUR and changes into 50/20/10/5 like the EUR profile.
+ *
+ * What the compiler does instead of the runtime machine:
+ * - validation is an unrolled chain of compares against constants
+ * - the greedy payout is unrolled over the payout notes and every
+ *   division is by a constant (a multiply)
+ * - the two states are an enum, no virtual dispatch
+ *
+ * When greedy fails, a bounded min-notes DP over the scaled amount
+ * (binary-split 0/1 knapsack) looks for another valid payout, so an
+ * exchange only fails when no valid combination exists.
+ *
+ * No currency profile, telemetry, journal or shared pool - that is
+ * what the runtime-configurable CashExchangeMachine is for.
+ */
+template <int... Notes>
+class StaticCashExchangeMachine {
+
+public:
+
+    using Inventory = StaticCashInventory<Notes...>;
+
+    static constexpr std::size_t kSize = Inventory::kSize;
+    static constexpr std::size_t kPayoutSize = kSize - 1;
+
+private:
+
+    /// Payout notes largest first, with their inventory slots
+    static constexpr std::array<int, kPayoutSize> payoutNotes() {
+        std::array<int, kPayoutSize> notes{};
+        for (std::size_t i = 0; i < kPayoutSize; ++i)
+            notes[i] = Inventory::kValues[kPayoutSize - 1 - i];
+        return notes;
+    }
+
+    static constexpr int payoutGcd() {
+        int g = 0;
+        for (int d : payoutNotes())
+            g = std::gcd(g, d);
+        return g;
+    }
+
+public:
+
+    static constexpr std::array<int, kPayoutSize> kPayout = payoutNotes();
+    static constexpr int kGcd = payoutGcd();
+
+private:
+
+    static constexpr int kUnreachable = INT_MAX / 2;
+
+    enum class State { Idle, HasMoney };
+
+    Inventory inventory_;
+    State state_{State::Idle};
+    int insertedAmount_{0};
+    int limit_;
+
+    /// Notes of the current transaction per inventory slot (for a cancel)
+    std::array<int, kSize> inserted_{};
+
+    /// Notes of the last payout, index-aligned with kPayout
+    std::array<int, kPayoutSize> payout_{};
+
+    // DP scratch, grows once
+    std::vector<int> best_;
+    std::vector<std::pair<int, int>> chunks_;   ///< (payout index, notes)
+    std::vector<unsigned char> used_;
+
+    static constexpr std::size_t payoutSlot(std::size_t i) {
+        return kSize - 2 - i;
+    }
+
+    /**
+     * @brief Largest-note-first walk, unrolled over the pack.
+     */
+    template <std::size_t... I>
+    bool greedy(int amount, std::index_sequence<I...>) {
+        int remaining = amount;
+        ((payout_[I] = std::min(inventory_.countAt(payoutSlot(I)), remaining / kPayout[I]),
+          remaining -= payout_[I] * kPayout[I]), ...);
+        return remaining == 0;
+    }
+
+    /**
+     * @brief Bounded min-notes payout (fallback when greedy fails).
+     *
+     * Each note bound is split into chunks 1, 2, 4, ..., rest; every
+     * chunk is then a 0/1 item and used_ records which chunks improved
+     * which amount, so the payout is read back from the last chunk down.
+     */
+    bool solve(int amount) {
+        if (amount % kGcd != 0)
+            return false;
+
+        const int target = amount / kGcd;
+        const std::size_t width = static_cast<std::size_t>(target) + 1;
+
+        best_.assign(width, kUnreachable);
+        best_[0] = 0;
+
+        chunks_.clear();
+        for (std::size_t i = 0; i < kPayoutSize; ++i) {
+            const int v = kPayout[i] / kGcd;
+            int bound = std::min(inventory_.countAt(payoutSlot(i)), target / v);
+            for (int k = 1; bound > 0; k *= 2) {
+                const int c = std::min(k, bound);
+                chunks_.push_back({static_cast<int>(i), c});
+                bound -= c;
+            }
+        }
+
+        used_.assign(chunks_.size() * width, 0);
+        for (std::size_t j = 0; j < chunks_.size(); ++j) {
+            const auto [i, c] = chunks_[j];
+            const int weight = kPayout[static_cast<std::size_t>(i)] / kGcd * c;
+            for (int w = target; w >= weight; --w) {
+                if (best_[w - weight] + c < best_[w]) {
+                    best_[w] = best_[w - weight] + c;
+                    used_[j * width + static_cast<std::size_t>(w)] = 1;
+                }
+            }
+        }
+
+        if (best_[target] >= kUnreachable)
+            return false;
+
+        payout_.fill(0);
+        int w = target;
+        for (std::size_t j = chunks_.size(); j-- > 0;) {
+            if (used_[j * width + static_cast<std::size_t>(w)]) {
+                const auto [i, c] = chunks_[j];
+                payout_[static_cast<std::size_t>(i)] += c;
+                w -= kPayout[static_cast<std::size_t>(i)] / kGcd * c;
+            }
+        }
+        return true;
+    }
+
+public:
+
+    /**
+     * @param stock initial notes per slot (ascending note order)
+     * @param limit most that may be inserted per transaction
+     */
+    explicit StaticCashExchangeMachine(const std::array<int, kSize>& stock,
+                                       int limit = 500)
+        : inventory_(stock), limit_(limit) {}
+
+    static constexpr bool accepts(int value) {
+        return Inventory::accepts(value);
+    }
+
+    void insertMoney(int amount) {
+        if (!Inventory::accepts(amount))
+            throw std::invalid_argument("Invalid denomination.");
+        if (insertedAmount_ + amount > limit_)
+            throw std::invalid_argument("Insert limit exceeded (max " +
+                                        std::to_string(limit_) + ").");
+
+        const auto slot = static_cast<std::size_t>(Inventory::slotOf(amount));
+        insertedAmount_ += amount;
+        ++inserted_[slot];
+        inventory_.addAt(slot);
+        state_ = State::HasMoney;
+    }
+
+    void exchange() {
+        if (state_ == State::Idle)
+            return;
+
+        if (!greedy(insertedAmount_, std::make_index_sequence<kPayoutSize>{}) &&
+            !solve(insertedAmount_)) {
+            payout_.fill(0);
+            throw std::runtime_error("Partial exchange - denominations unavailable.");
+        }
+
+        for (std::size_t i = 0; i < kPayoutSize; ++i)
+            inventory_.removeAt(payoutSlot(i), payout_[i]);
+
+        insertedAmount_ = 0;
+        inserted_.fill(0);
+        state_ = State::Idle;
+    }
+
+    /**
+     * @brief Hand the inserted notes back and return to Idle.
+     *
+     * The inventory belongs to this machine alone and a failed exchange
+     * leaves it untouched, so the customer's own notes are still there:
+     * a cancel cannot fail.
+     */
+    void cancel() {
+        for (std::size_t i = 0; i < kSize; ++i)
+            inventory_.removeAt(i, inserted_[i]);
+        inserted_.fill(0);
+        insertedAmount_ = 0;
+        state_ = State::Idle;
+    }
+
+    void refill(int value, int count) {
+        inventory_.refill(value, count);
+    }
+
+    int getInserted() const {
+        return insertedAmount_;
+    }
+
+    const Inventory& inventory() const {
+        return inventory_;
+    }
+
+    /**
+     * @brief Notes of the last exchange, index-aligned with kPayout.
+     */
+    const std::array<int, kPayoutSize>& lastPayout() const {
+        return payout_;
+    }
+};
@@ -0,0 +1,127 @@
+/**
+ * @file static_machine_bench.cpp
+ * @brief Runtime-configured vs compile-time specialized exchange machine.
+ *
+ * @details
+ * Replays the same pre-generated trace (1-3 random notes, exchange,
+ * an occasional refill of small notes) against:
+ *
+ * - runtime: CashExchangeMachine with the EUR CurrencyProfile
+ * - static:  StaticCashExchangeMachine<5, 10, 20, 50, 100>
+ *
+ * and reports events per second, partial exchanges and whether both
+ * machines end with the same inventory. The runtime machine also keeps
+ * telemetry and its payout cache; the static one has neither, which is
+ * part of what specializing buys.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 static_machine_bench.cpp -o static_machine_bench
+ * ./static_machine_bench [transactions]      (default: 2000000)
+ */
+
+#include "cash_exchange_machine.h"
+#include "static_cash_exchange_machine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using EuroMachine = StaticCashExchangeMachine<5, 10, 20, 50, 100>;
+
+// Checked by the compiler, not at run time
+static_assert(EuroMachine::accepts(20) && !EuroMachine::accepts(25), "EUR notes");
+static_assert(EuroMachine::kPayout[0] == 50 && EuroMachine::kPayout[3] == 5, "payout order");
+static_assert(EuroMachine::kGcd == 5, "payout step");
+
+/**
+ * @struct Op
+ * @brief One replayed event: insert (value), exchange (0), refill (-value).
+ */
+struct Op {
+    int value;
+};
+
+std::vector<Op> generate(long transactions) {
+    std::mt19937 rng(7);
+    const int notes[] = {5, 10, 20, 50, 100};
+
+    std::vector<Op> ops;
+    ops.reserve(static_cast<std::size_t>(transactions) * 4);
+    for (long t = 0; t < transactions; ++t) {
+        int count = 1 + static_cast<int>(rng() % 3);
+        for (int i = 0; i < count; ++i)
+            ops.push_back({notes[rng() % 5]});
+        ops.push_back({0});
+        if (rng() % 16 == 0)
+            ops.push_back({-notes[rng() % 4]});
+    }
+    return ops;
+}
+
+/**
+ * @brief Replays the trace, returns events per second.
+ */
+template <typename Machine>
+double replay(Machine& machine, const std::vector<Op>& ops, long& partial) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (const Op& op : ops) {
+        if (op.value > 0) {
+            machine.insertMoney(op.value);
+        } else if (op.value < 0) {
+            machine.refill(-op.value, 20);
+        } else {
+            try {
+                machine.exchange();
+            } catch (const std::runtime_error&) {
+                ++partial;
+                machine.cancel();
+            }
+        }
+    }
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(ops.size()) / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+
+    long transactions = (argc > 1) ? std::atol(argv[1]) : 2'000'000L;
+    const std::vector<Op> ops = generate(transactions);
+
+    CashExchangeMachine runtime;
+    EuroMachine specialized({20, 20, 20, 10, 5});
+
+    long runtimePartial = 0;
+    long staticPartial = 0;
+
+    // After a partial exchange both machines refund the notes
+    struct Runtime {
+        CashExchangeMachine& m;
+        void insertMoney(int v) { m.insertMoney(v); }
+        void exchange() { m.exchange(); }
+        void refill(int v, int n) { m.refill(v, n); }
+        void cancel() { m.tryCancel(); }
+    } runtimeDriver{runtime};
+
+    double runtimeRate = replay(runtimeDriver, ops, runtimePartial);
+    double staticRate = replay(specialized, ops, staticPartial);
+
+    bool same = runtime.getInserted() == Money::fromUnits(specialized.getInserted());
+    for (int note : EuroMachine::Inventory::kValues)
+        same = same && runtime.inventory().count(note) == specialized.inventory().count(note);
+
+    std::cout << "Events: " << ops.size() << "\n"
+              << "runtime (CurrencyProfile):        " << static_cast<long>(runtimeRate)
+              << " events/s, partial " << runtimePartial << "\n"
+              << "static  <5, 10, 20, 50, 100>:     " << static_cast<long>(staticRate)
+              << " events/s, partial " << staticPartial << "\n"
+              << "speed-up: " << staticRate / runtimeRate << "x\n"
+              << (same ? "Final inventories match." : "Final inventories differ.") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,484 @@
+/**
+ * @file transaction_journal.h
+ * @brief Append-only, memory-mapped transaction journal with snapshots.
+ */
+#pragma once
+
+#include "cash_inventory.h"
+#include "payout_plan.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ============================================================
+   TRANSACTION JOURNAL
+   Concept: Event sourcing + RAII over a memory-mapped file
+   ============================================================ */
+
+/**
+ * @class TransactionJournal
+ * @brief Crash-safe event log of one cash exchange machine.
+ *
+ * File layout:
+ *
+ *   [ header page: magic, geometry, two snapshot slots ]
+ *   [ record 0 ][ record 1 ] ... [ record capacity-1 ]
+ *
+ * Every insert, exchange, refund and refill becomes one fixed-size 64-byte
+ * record, written straight into the mapping. Records are flushed to
+ * disk with msync() once per `groupSize` appends (group commit), or
+ * when flush() is called. A process crash loses nothing - the pages
+ * live in the page cache - while an OS crash loses at most the last
+ * unflushed group.
+ *
+ * When the record area is full, a snapshot of the inventory counts
+ * and the notes of the open transaction is written to the older of the two snapshot
+ * slots and the record area is reused from the start. Recovery loads
+ * the newest valid snapshot and replays only the records written
+ * after it, so it touches at most `capacity` records no matter how
+ * many transactions the machine has processed.
+ *
+ * RAII: the constructor opens and maps the file, the destructor
+ * flushes and unmaps it.
+ */
+class TransactionJournal {
+
+public:
+
+    /// Snapshots and records are sized for this many denominations
+    static constexpr std::size_t kMaxSlots = kMaxDenominations;
+
+    /// Notes of one denomination that one record can hold
+    static constexpr int kMaxNotesPerRecord = UINT16_MAX;
+
+    enum class RecordType : std::uint8_t {
+        Insert   = 1,
+        Exchange = 2,
+        Refill   = 3,
+        Refund   = 4      ///< cancelled transaction, notes returned
+    };
+
+    /**
+     * @struct State
+     * @brief Machine state rebuilt by recover().
+     */
+    struct State {
+        std::array<int, kMaxSlots> counts{};   ///< notes per profile slot
+        std::array<int, kMaxSlots> inserted{}; ///< notes of the open transaction
+        int insertedAmount{0};
+        std::uint64_t sequence{0};             ///< last applied record
+    };
+
+private:
+
+    /**
+     * @struct Record
+     * @brief One event, exactly one cache line.
+     *
+     * Notes moved are stored per profile slot, so a payout using
+     * every denomination of the profile still fits one record.
+     */
+    struct Record {
+        std::uint64_t sequence;    ///< 1-based, 0 = never written
+        RecordType type;
+        std::uint8_t reserved[3];
+        std::int32_t amount;       ///< inserted note / exchanged amount
+        std::uint32_t checksum;
+        std::uint32_t reserved2[3];
+        std::uint16_t notes[kMaxSlots];   ///< notes in or out, per slot
+    };
+
+    static_assert(sizeof(Record) == 64, "one record per cache line");
+
+    struct Snapshot {
+        std::uint64_t sequence;
+        std::int64_t insertedAmount;
+        std::int32_t counts[kMaxSlots];
+        std::uint16_t inserted[kMaxSlots];   ///< notes of the open transaction
+        std::uint32_t slots;
+        std::uint32_t checksum;
+        char currency[8];          ///< profile code, NUL padded
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint64_t capacity;
+        Snapshot snapshots[2];
+    };
+
+    static constexpr char kMagic[8] = {'C', 'X', 'J', 'O', 'U', 'R', 'N', '1'};
+    static constexpr std::uint32_t kVersion = 3;
+    static constexpr std::size_t kHeaderBytes = 4096;
+
+    static_assert(sizeof(Header) <= kHeaderBytes, "header fits its page");
+
+    int fd_{-1};
+    unsigned char* base_{nullptr};
+    std::size_t mappedBytes_{0};
+
+    Header* header_{nullptr};
+    Record* records_{nullptr};
+    std::size_t capacity_{0};
+
+    std::size_t cursor_{0};        ///< next record index
+    std::size_t syncedUpTo_{0};    ///< records [0, syncedUpTo_) are on disk
+    std::size_t groupSize_;
+    std::uint64_t sequence_{0};    ///< last written sequence number
+
+    /**
+     * @brief FNV-1a over a byte range.
+     */
+    static std::uint32_t checksum(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        std::uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    static std::uint32_t checksum(Record record) {
+        record.checksum = 0;
+        return checksum(&record, sizeof(record));
+    }
+
+    static std::uint32_t checksum(Snapshot snapshot) {
+        snapshot.checksum = 0;
+        return checksum(&snapshot, sizeof(snapshot));
+    }
+
+    static bool valid(const Snapshot& s) {
+        return s.sequence != 0 && s.checksum == checksum(s);
+    }
+
+    static bool matches(const Snapshot& s, const CurrencyProfile& profile) {
+        char code[sizeof(s.currency)] = {};
+        profile.code().copy(code, sizeof(code) - 1);
+        return s.slots == profile.size() &&
+               std::memcmp(s.currency, code, sizeof(code)) == 0;
+    }
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::runtime_error("Journal: " + what + " (" + std::strerror(errno) + ")");
+    }
+
+    /**
+     * @brief msync() the pages covering a byte range of the mapping.
+     */
+    void sync(std::size_t offset, std::size_t bytes) {
+        static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t begin = offset / page * page;
+        if (msync(base_ + begin, offset + bytes - begin, MS_SYNC) != 0)
+            fail("msync failed");
+    }
+
+    Record& next() {
+        if (cursor_ >= capacity_)
+            throw std::length_error("Journal: record area full, snapshot first.");
+        Record& r = records_[cursor_];
+        std::memset(&r, 0, sizeof(r));
+        r.sequence = ++sequence_;
+        return r;
+    }
+
+    void commit(Record& r) {
+        r.checksum = checksum(r);
+        ++cursor_;
+        if (cursor_ - syncedUpTo_ >= groupSize_)
+            flush();
+    }
+
+    /**
+     * @brief Zero and sync every record after the cursor.
+     *
+     * Records past the end of a replay are stale or were never
+     * acknowledged. New appends reuse their sequence numbers, so after
+     * a second crash one of them could line up and be replayed; zeroed,
+     * none can. Only the span up to the last non-zero record is written.
+     */
+    void discardTail() {
+        static const Record kZero{};
+        std::size_t end = capacity_;
+        while (end > cursor_ && std::memcmp(&records_[end - 1], &kZero, sizeof(Record)) == 0)
+            --end;
+        if (end == cursor_)
+            return;
+        std::memset(static_cast<void*>(&records_[cursor_]), 0, (end - cursor_) * sizeof(Record));
+        sync(kHeaderBytes + cursor_ * sizeof(Record), (end - cursor_) * sizeof(Record));
+    }
+
+    void open(const std::string& path, std::size_t capacity) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0)
+            fail("cannot open " + path);
+
+        struct stat st {};
+        if (fstat(fd_, &st) != 0)
+            fail("cannot stat " + path);
+
+        const bool fresh = st.st_size == 0;
+        if (!fresh) {
+            if (static_cast<std::size_t>(st.st_size) < kHeaderBytes + sizeof(Record))
+                throw std::runtime_error("Journal: " + path + " is truncated.");
+            capacity = (static_cast<std::size_t>(st.st_size) - kHeaderBytes) / sizeof(Record);
+        }
+
+        mappedBytes_ = kHeaderBytes + capacity * sizeof(Record);
+        if (fresh && ftruncate(fd_, static_cast<off_t>(mappedBytes_)) != 0)
+            fail("cannot size " + path);
+
+        void* p = mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED)
+            fail("cannot map " + path);
+
+        base_ = static_cast<unsigned char*>(p);
+        header_ = reinterpret_cast<Header*>(base_);
+        records_ = reinterpret_cast<Record*>(base_ + kHeaderBytes);
+        capacity_ = capacity;
+
+        if (fresh) {
+            std::memcpy(header_->magic, kMagic, sizeof(kMagic));
+            header_->version = kVersion;
+            header_->recordSize = sizeof(Record);
+            header_->capacity = capacity_;
+            sync(0, kHeaderBytes);
+        } else if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+                   header_->version != kVersion ||
+                   header_->recordSize != sizeof(Record)) {
+            throw std::runtime_error("Journal: " + path + " has an unknown format.");
+        }
+    }
+
+    void close() {
+        if (base_)
+            munmap(base_, mappedBytes_);
+        if (fd_ >= 0)
+            ::close(fd_);
+        base_ = nullptr;
+        fd_ = -1;
+    }
+
+public:
+
+    /**
+     * @brief Open (or create) a journal file.
+     * @param path      journal file
+     * @param capacity  records between two snapshots (new files only)
+     * @param groupSize appends per msync() (group commit)
+     */
+    explicit TransactionJournal(const std::string& path,
+                                std::size_t capacity = 1 << 16,
+                                std::size_t groupSize = 64)
+        : groupSize_(groupSize ? groupSize : 1) {
+        try {
+            open(path, capacity);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    ~TransactionJournal() {
+        if (base_)
+            msync(base_, mappedBytes_, MS_SYNC);
+        close();
+    }
+
+    TransactionJournal(const TransactionJournal&) = delete;
+    TransactionJournal& operator=(const TransactionJournal&) = delete;
+
+    /**
+     * @brief Rebuild the machine state from snapshot + record tail.
+     * @param profile currency the journal must belong to
+     * @param[out] state recovered counts, inserted notes (per profile slot)
+     *                   and inserted amount
+     * @return false if the journal holds no snapshot yet (fresh file)
+     *
+     * Leaves the append cursor right after the last valid record,
+     * with the rest of the record area zeroed.
+     */
+    bool recover(const CurrencyProfile& profile, State& state) {
+        const Snapshot* newest = nullptr;
+        for (const Snapshot& s : header_->snapshots)
+            if (valid(s) && (!newest || s.sequence > newest->sequence))
+                newest = &s;
+
+        if (!newest) {
+            cursor_ = 0;
+            discardTail();
+            return false;
+        }
+        if (!matches(*newest, profile))
+            throw std::runtime_error("Journal: written for another currency profile.");
+
+        for (std::size_t i = 0; i < profile.size(); ++i) {
+            state.counts[i] = newest->counts[i];
+            state.inserted[i] = newest->inserted[i];
+        }
+        state.insertedAmount = static_cast<int>(newest->insertedAmount);
+        sequence_ = newest->sequence;
+
+        // Replay the tail; it ends at the first stale or torn record
+        cursor_ = 0;
+        while (cursor_ < capacity_) {
+            const Record& r = records_[cursor_];
+            if (r.sequence != sequence_ + 1 || r.checksum != checksum(r))
+                break;
+
+            switch (r.type) {
+            case RecordType::Insert:
+                for (std::size_t i = 0; i < kMaxSlots; ++i) {
+                    state.counts[i] += r.notes[i];
+                    state.inserted[i] += r.notes[i];
+                }
+                state.insertedAmount += r.amount;
+                break;
+            case RecordType::Exchange:
+            case RecordType::Refund:
+                for (std::size_t i = 0; i < kMaxSlots; ++i)
+                    state.counts[i] -= r.notes[i];
+                state.inserted.fill(0);
+                state.insertedAmount = 0;
+                break;
+            case RecordType::Refill:
+                for (std::size_t i = 0; i < kMaxSlots; ++i)
+                    state.counts[i] += r.notes[i];
+                break;
+            }
+
+            sequence_ = r.sequence;
+            ++cursor_;
+        }
+
+        syncedUpTo_ = cursor_;
+        discardTail();
+        state.sequence = sequence_;
+        return true;
+    }
+
+    /**
+     * @brief Write a snapshot and restart the record area.
+     *
+     * The snapshot goes to the older slot, so a crash half-way
+     * leaves the previous snapshot and its records intact.
+     */
+    void snapshot(const CashInventory& inventory, const std::array<int, kMaxSlots>& inserted) {
+        flush();
+
+        Snapshot& a = header_->snapshots[0];
+        Snapshot& b = header_->snapshots[1];
+        Snapshot& target = (!valid(a) || (valid(b) && a.sequence < b.sequence)) ? a : b;
+
+        Snapshot s{};
+        s.sequence = sequence_ ? sequence_ : ++sequence_;
+        const CurrencyProfile& profile = inventory.profile();
+        s.slots = static_cast<std::uint32_t>(profile.size());
+        profile.code().copy(s.currency, sizeof(s.currency) - 1);
+        for (std::size_t i = 0; i < profile.size(); ++i) {
+            s.counts[i] = inventory.countAt(i);
+            s.inserted[i] = static_cast<std::uint16_t>(inserted[i]);
+            s.insertedAmount += static_cast<std::int64_t>(inserted[i]) * profile.value(i);
+        }
+        s.checksum = checksum(s);
+
+        target = s;
+        sync(0, kHeaderBytes);
+
+        cursor_ = 0;
+        syncedUpTo_ = 0;
+    }
+
+    /**
+     * @brief True if every event of `profile` fits one record.
+     *
+     * The largest payout is the insert limit in the smallest note.
+     */
+    static bool supports(const CurrencyProfile& profile) {
+        if (profile.size() > kMaxSlots)
+            return false;
+        int smallest = profile.limit();
+        for (std::size_t i = 0; i < profile.size(); ++i)
+            smallest = std::min(smallest, profile.value(i));
+        return smallest > 0 && profile.limit() / smallest <= kMaxNotesPerRecord;
+    }
+
+    /**
+     * @brief True when the record area is full and needs a snapshot.
+     */
+    bool needsSnapshot() const {
+        return cursor_ >= capacity_;
+    }
+
+    /**
+     * @brief Event appenders; values are mapped to slots of `profile`.
+     */
+    void appendInsert(const CurrencyProfile& profile, int amount) {
+        Record& r = next();
+        r.type = RecordType::Insert;
+        r.amount = amount;
+        r.notes[profile.slotOf(amount)] = 1;
+        commit(r);
+    }
+
+    void appendExchange(const CurrencyProfile& profile, int amount, const PayoutPlan& plan) {
+        Record& r = next();
+        r.type = RecordType::Exchange;
+        r.amount = amount;
+        for (const PayoutEntry& e : plan)
+            r.notes[profile.slotOf(e.denomination)] = static_cast<std::uint16_t>(e.count);
+        commit(r);
+    }
+
+    void appendRefund(const CurrencyProfile& profile, int amount, const PayoutPlan& plan) {
+        Record& r = next();
+        r.type = RecordType::Refund;
+        r.amount = amount;
+        for (const PayoutEntry& e : plan)
+            r.notes[profile.slotOf(e.denomination)] = static_cast<std::uint16_t>(e.count);
+        commit(r);
+    }
+
+    void appendRefill(const CurrencyProfile& profile, int denomination, int count) {
+        if (count > kMaxNotesPerRecord)
+            throw std::length_error("Journal: refill too large for one record.");
+
+        Record& r = next();
+        r.type = RecordType::Refill;
+        r.amount = denomination;
+        r.notes[profile.slotOf(denomination)] = static_cast<std::uint16_t>(count);
+        commit(r);
+    }
+
+    /**
+     * @brief Force every appended record to disk.
+     */
+    void flush() {
+        if (cursor_ > syncedUpTo_) {
+            sync(kHeaderBytes + syncedUpTo_ * sizeof(Record),
+                 (cursor_ - syncedUpTo_) * sizeof(Record));
+            syncedUpTo_ = cursor_;
+        }
+    }
+
+    std::uint64_t sequence() const {
+        return sequence_;
+    }
+
+    std::size_t capacity() const {
+        return capacity_;
+    }
+};
@@ -0,0 +1,234 @@
+/**
+ * @file money.h
+ * @brief Fixed-point money value in integer cents, shared by the machines.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+/* ============================================================
+   MONEY VALUE TYPE
+   Concept: Strong typing + exact fixed-point arithmetic
+   ============================================================ */
+
+/**
+ * @class Money
+ * @brief An amount of money as a whole number of cents.
+ *
+ * Exact where double is not (0.55 + 0.45 really is 1.00), and a
+ * distinct type so an amount cannot be mixed up with a count or an
+ * index by accident.
+ *
+ * Every value stays within ±kLimit cents (about 90 trillion units).
+ * Arithmetic that would leave that range throws std::overflow_error.
+ * Because two in-range values can never overflow std::int64_t when
+ * added, the check is one compare on the result, and a Money is just
+ * an int64 in registers - no heap, no hidden state.
+ *
+ * The range also makes sum() exact and vectorizable: a block of up
+ * to kSumBlock values is added with plain integer adds (no branch
+ * per element) and only the block total is checked.
+ */
+class Money {
+
+public:
+
+    using Rep = std::int64_t;
+
+    static constexpr Rep kCentsPerUnit = 100;
+    static constexpr Rep kLimit = Rep{1} << 53;
+
+    /// Values per unchecked block in sum(): kSumBlock * kLimit < 2^63
+    static constexpr std::size_t kSumBlock = 512;
+
+private:
+
+    Rep cents_{0};
+
+    static constexpr Rep checked(Rep cents) {
+        if (cents > kLimit || cents < -kLimit)
+            throw std::overflow_error("Money out of range.");
+        return cents;
+    }
+
+    struct Raw {};
+    constexpr Money(Rep cents, Raw) : cents_(cents) {}
+
+public:
+
+    constexpr Money() = default;
+
+    /* ---------- factories ---------- */
+
+    static constexpr Money fromCents(Rep cents) {
+        return Money(checked(cents), Raw{});
+    }
+
+    static constexpr Money fromUnits(Rep units) {
+        if (units > kLimit / kCentsPerUnit || units < -kLimit / kCentsPerUnit)
+            throw std::overflow_error("Money out of range.");
+        return Money(units * kCentsPerUnit, Raw{});
+    }
+
+    /**
+     * @brief Parse "12", "12.5", "12.50" or "-0.05" (no doubles involved).
+     */
+    static Money parse(const std::string& text) {
+        std::size_t i = 0;
+        bool negative = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+'))
+            negative = text[i++] == '-';
+
+        Rep units = 0;
+        std::size_t digits = 0;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i, ++digits) {
+            units = units * 10 + (text[i] - '0');
+            if (units > kLimit / kCentsPerUnit)
+                throw std::overflow_error("Money out of range.");
+        }
+
+        Rep cents = 0;
+        if (i < text.size() && text[i] == '.') {
+            ++i;
+            for (Rep scale = 10; scale > 0; scale /= 10, ++i) {
+                if (i >= text.size())
+                    break;
+                if (text[i] < '0' || text[i] > '9')
+                    throw std::invalid_argument("Bad money value '" + text + "'.");
+                cents += (text[i] - '0') * scale;
+                ++digits;
+            }
+        }
+        if (digits == 0 || i != text.size())
+            throw std::invalid_argument("Bad money value '" + text + "'.");
+
+        Rep total = units * kCentsPerUnit + cents;
+        return fromCents(negative ? -total : total);
+    }
+
+    /* ---------- access ---------- */
+
+    constexpr Rep cents() const {
+        return cents_;
+    }
+
+    /// Whole units, truncated toward zero
+    constexpr Rep units() const {
+        return cents_ / kCentsPerUnit;
+    }
+
+    constexpr bool isWhole() const {
+        return cents_ % kCentsPerUnit == 0;
+    }
+
+    /* ---------- arithmetic (range-checked) ---------- */
+
+    constexpr Money operator+(Money other) const {
+        return fromCents(cents_ + other.cents_);
+    }
+
+    constexpr Money operator-(Money other) const {
+        return fromCents(cents_ - other.cents_);
+    }
+
+    constexpr Money operator-() const {
+        return Money(-cents_, Raw{});
+    }
+
+    constexpr Money operator*(Rep factor) const {
+        // Any factor, INT64_MIN included: the product is checked, not the operand
+        Rep cents = 0;
+        if (__builtin_mul_overflow(cents_, factor, &cents))
+            throw std::overflow_error("Money out of range.");
+        return fromCents(cents);
+    }
+
+    /// How many times `part` fits (e.g. notes of one value in an amount)
+    constexpr Rep operator/(Money part) const {
+        if (part.cents_ == 0)
+            throw std::domain_error("Division by zero money.");
+        return cents_ / part.cents_;
+    }
+
+    /// What is left after taking whole `part`s
+    constexpr Money operator%(Money part) const {
+        if (part.cents_ == 0)
+            throw std::domain_error("Division by zero money.");
+        return Money(cents_ % part.cents_, Raw{});
+    }
+
+    constexpr Money& operator+=(Money other) {
+        return *this = *this + other;
+    }
+
+    constexpr Money& operator-=(Money other) {
+        return *this = *this - other;
+    }
+
+    /* ---------- comparison ---------- */
+
+    constexpr bool operator==(Money o) const { return cents_ == o.cents_; }
+    constexpr bool operator!=(Money o) const { return cents_ != o.cents_; }
+    constexpr bool operator<(Money o) const { return cents_ < o.cents_; }
+    constexpr bool operator<=(Money o) const { return cents_ <= o.cents_; }
+    constexpr bool operator>(Money o) const { return cents_ > o.cents_; }
+    constexpr bool operator>=(Money o) const { return cents_ >= o.cents_; }
+
+    /* ---------- batch ---------- */
+
+    /**
+     * @brief Exact total of `n` amounts.
+     *
+     * Inner loop: plain int64 adds over a block (auto-vectorized).
+     * Outer loop: one range check per block.
+     */
+    static Money sum(const Money* values, std::size_t n) {
+        Money total;
+        for (std::size_t base = 0; base < n; base += kSumBlock) {
+            const std::size_t end = (n - base < kSumBlock) ? n : base + kSumBlock;
+            Rep block = 0;
+            for (std::size_t i = base; i < end; ++i)
+                block += values[i].cents_;
+            total += fromCents(block);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Exact sum of price[i] * count[i].
+     */
+    static Money dot(const Money* prices, const int* counts, std::size_t n) {
+        Money total;
+        for (std::size_t i = 0; i < n; ++i)
+            total += prices[i] * counts[i];
+        return total;
+    }
+};
+
+static_assert(sizeof(Money) == sizeof(std::int64_t), "Money is a plain integer");
+static_assert(Money::kSumBlock * static_cast<unsigned long long>(Money::kLimit) <
+                  (1ULL << 63),
+              "an unchecked block cannot overflow");
+static_assert(Money::fromCents(55) + Money::fromCents(45) == Money::fromUnits(1),
+              "exact decimal arithmetic");
+
+/**
+ * @brief Prints "12.34" (sign first, always two decimals).
+ */
+inline std::ostream& operator<<(std::ostream& out, Money m) {
+    Money::Rep c = m.cents();
+    if (c < 0) {
+        out << '-';
+        c = -c;
+    }
+    const char fill = out.fill('0');
+    out << c / Money::kCentsPerUnit << '.' << std::setw(2) << c % Money::kCentsPerUnit;
+    out.fill(fill);
+    return out;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file analytics_bench.cpp
+ * @brief SalesAnalytics: record throughput, window sums, top-K accuracy.
+ *
+ * @details
+ * A Zipf-distributed (s = 1.1) stream of `events` sales over
+ * `products` SKUs, spread over two simulated days so every ring
+ * wraps.
+ *
+ * 1. Throughput: ns per record(), alone and while a reader thread
+ *    queries bestsellers and window sums as fast as it can. Readers
+ *    never block the writer, so the two should be close (on one core
+ *    they share it, of course).
+ * 2. Windows: minute / hour / day sums of the 20 best SKUs at the end
+ *    of the stream, checked against exact counts from the stream.
+ * 3. Top K: recall of the true top K, and whether every exact count
+ *    lies in the reported [units - error, units].
+ *
+ * @usage
+ * g++ -std=c++17 -O2 -pthread analytics_bench.cpp -o analytics_bench
+ * ./analytics_bench [events] [products] [top_k]   (default: 20000000 20000 10)
+ */
+
+#include "sales_analytics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+using Window = SalesAnalytics::Window;
+
+constexpr std::uint32_t kSimulatedSeconds = 2 * 86400;
+
+std::uint32_t secondOf(std::size_t event, std::size_t events) {
+    return static_cast<std::uint32_t>(static_cast<double>(event) * kSimulatedSeconds /
+                                      static_cast<double>(events));
+}
+
+std::vector<std::uint32_t> zipfStream(std::size_t events, std::size_t products, unsigned seed) {
+    std::vector<double> cdf(products);
+    double sum = 0;
+    for (std::size_t i = 0; i < products; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), 1.1);
+        cdf[i] = sum;
+    }
+
+    // Shuffle ranks so the bestsellers are not simply the low indexes
+    std::vector<std::uint32_t> sku(products);
+    for (std::size_t i = 0; i < products; ++i)
+        sku[i] = static_cast<std::uint32_t>(i);
+    std::mt19937 rng(seed);
+    std::shuffle(sku.begin(), sku.end(), rng);
+
+    std::uniform_real_distribution<double> u(0, sum);
+    std::vector<std::uint32_t> stream(events);
+    for (std::uint32_t& s : stream) {
+        const auto rank = std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin();
+        s = sku[static_cast<std::size_t>(std::min<std::ptrdiff_t>(
+            rank, static_cast<std::ptrdiff_t>(products - 1)))];
+    }
+    return stream;
+}
+
+/**
+ * @brief Feeds the stream; returns ns per record.
+ */
+double feed(SalesAnalytics& analytics, const std::vector<std::uint32_t>& stream) {
+    auto start = Clock::now();
+    for (std::size_t e = 0; e < stream.size(); ++e)
+        analytics.record(stream[e], 1, secondOf(e, stream.size()));
+    analytics.publish();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / static_cast<double>(stream.size());
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t events = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20'000'000;
+    std::size_t products = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 20'000;
+    std::size_t topK = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 10;
+    events = std::max<std::size_t>(events, 1);
+    products = std::max<std::size_t>(products, 1);
+    topK = std::max<std::size_t>(std::min(topK, products), 1);
+
+    const std::vector<std::uint32_t> stream = zipfStream(events, products, 5);
+
+    // 1. Throughput, alone and with a concurrent reader
+    SalesAnalytics alone(products, topK);
+    const double aloneNs = feed(alone, stream);
+
+    SalesAnalytics analytics(products, topK);
+    std::atomic<bool> done{false};
+    long queries = 0;
+    std::thread reader([&] {
+        std::vector<SalesAnalytics::Bestseller> top(topK);
+        std::uint64_t sink = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            const std::size_t n = analytics.bestsellers(top.data(), top.size());
+            for (std::size_t i = 0; i < n; ++i)
+                sink += analytics.unitsIn(top[i].index, Window::Minute, kSimulatedSeconds);
+            ++queries;
+        }
+        queries += static_cast<long>(sink & 1);
+    });
+    const double sharedNs = feed(analytics, stream);
+    done = true;
+    reader.join();
+
+    std::cout << "Stream: " << events << " sales over " << products << " SKUs, "
+              << analytics.memoryBytes() / (1024 * 1024) << " MiB of analytics\n"
+              << "  record(): " << aloneNs << " ns (" << static_cast<long>(1e9 / aloneNs)
+              << " /s) alone, " << sharedNs << " ns with a reader (" << queries
+              << " queries)\n";
+
+    // Exact counts, overall and per window at the end of the stream
+    const std::uint32_t end = secondOf(events - 1, events);
+    struct Exact {
+        std::uint64_t total, minute, hour, day;
+    };
+    std::vector<Exact> exact(products, Exact{0, 0, 0, 0});
+    for (std::size_t e = 0; e < events; ++e) {
+        const std::uint32_t t = secondOf(e, events);
+        Exact& x = exact[stream[e]];
+        ++x.total;
+        x.minute += end / 1 - t / 1 < 60;
+        x.hour += end / 60 - t / 60 < 60;
+        x.day += end / 3600 - t / 3600 < 24;
+    }
+
+    std::vector<std::uint32_t> byTotal(products);
+    for (std::size_t i = 0; i < products; ++i)
+        byTotal[i] = static_cast<std::uint32_t>(i);
+    std::sort(byTotal.begin(), byTotal.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return exact[a].total > exact[b].total;
+    });
+
+    // 2. Windows
+    int windowErrors = 0;
+    for (std::size_t r = 0; r < std::min<std::size_t>(20, products); ++r) {
+        const std::uint32_t i = byTotal[r];
+        windowErrors += analytics.unitsIn(i, Window::Minute, end) != exact[i].minute;
+        windowErrors += analytics.unitsIn(i, Window::Hour, end) != exact[i].hour;
+        windowErrors += analytics.unitsIn(i, Window::Day, end) != exact[i].day;
+    }
+    const std::uint32_t best = byTotal[0];
+    std::cout << "Windows (best SKU " << best << "): minute " << exact[best].minute
+              << ", hour " << exact[best].hour << ", day " << exact[best].day
+              << " (" << (windowErrors == 0 ? "all 20 checked SKUs exact" : "WINDOW MISMATCH")
+              << ")\n";
+
+    // 3. Top K
+    const std::vector<SalesAnalytics::Bestseller> top = analytics.bestsellers();
+    std::size_t hits = 0;
+    bool bounded = true;
+    std::uint64_t maxError = 0;
+    for (const SalesAnalytics::Bestseller& b : top) {
+        hits += std::find(byTotal.begin(), byTotal.begin() + static_cast<std::ptrdiff_t>(topK),
+                          static_cast<std::uint32_t>(b.index)) !=
+                byTotal.begin() + static_cast<std::ptrdiff_t>(topK);
+        const std::uint64_t truth = exact[b.index].total;
+        bounded = bounded && truth <= b.units && b.units - b.error <= truth;
+        maxError = std::max(maxError, b.units - truth);
+    }
+    std::cout << "Top " << topK << ": recall " << hits << "/" << topK << ", max overcount "
+              << maxError << " (" << (bounded ? "every count within its error bound"
+                                               : "COUNT OUTSIDE ITS BOUND")
+              << ")\n";
+
+    return (windowErrors == 0 && bounded) ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file catalog_bench.cpp
+ * @brief Build and lookup cost of ProductCatalog with millions of SKUs.
+ *
+ * @details
+ * 1. Builds a catalog of N products with sparse random SKU ids and
+ *    names like "product-0001234".
+ * 2. Looks up random SKUs by id and by name (hits and misses) and
+ *    sells every product found.
+ * 3. Repeats the name lookups against a std::unordered_map<std::string,
+ *    std::size_t> index as a baseline.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 catalog_bench.cpp -o catalog_bench
+ * ./catalog_bench [products] [lookups]      (default: 2000000 5000000)
+ */
+
+#include "product_catalog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+double nanosSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+std::string productName(std::size_t i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "product-%07zu", i);
+    return buf;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t products = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2'000'000;
+    std::size_t lookups = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 5'000'000;
+
+    std::mt19937_64 rng(19);
+
+    // Distinct sparse ids
+    std::vector<ProductCatalog::Sku> ids(products);
+    for (std::size_t i = 0; i < products; ++i)
+        ids[i] = (static_cast<ProductCatalog::Sku>(i) << 20) | (rng() & 0xFFFFF);
+
+    ProductCatalog catalog;
+    auto start = Clock::now();
+    catalog.reserve(products, products * 15);
+    for (std::size_t i = 0; i < products; ++i)
+        catalog.add(ids[i], productName(i), Money::fromCents(50 + static_cast<long>(i % 400)), 10);
+    const double buildMs = nanosSince(start) / 1e6;
+
+    // Queries: 90 % hits, 10 % misses
+    std::vector<ProductCatalog::Sku> idQueries(lookups);
+    std::vector<std::string> nameQueries(lookups);
+    for (std::size_t q = 0; q < lookups; ++q) {
+        std::size_t i = rng() % products;
+        bool miss = rng() % 10 == 0;
+        idQueries[q] = miss ? ids[i] | (1ULL << 63) : ids[i];
+        nameQueries[q] = miss ? productName(products + i) : productName(i);
+    }
+
+    std::size_t found = 0;
+    start = Clock::now();
+    for (ProductCatalog::Sku id : idQueries) {
+        std::size_t index = catalog.find(id);
+        if (index != ProductCatalog::npos) {
+            catalog.sell(index);
+            ++found;
+        }
+    }
+    const double byId = nanosSince(start) / static_cast<double>(lookups);
+
+    std::size_t foundByName = 0;
+    start = Clock::now();
+    for (const std::string& name : nameQueries)
+        foundByName += catalog.findByName(name) != ProductCatalog::npos;
+    const double byName = nanosSince(start) / static_cast<double>(lookups);
+
+    // Baseline: node-based map keyed by std::string
+    std::unordered_map<std::string, std::size_t> map;
+    start = Clock::now();
+    map.reserve(products);
+    for (std::size_t i = 0; i < products; ++i)
+        map.emplace(productName(i), i);
+    const double mapBuildMs = nanosSince(start) / 1e6;
+
+    std::size_t foundInMap = 0;
+    start = Clock::now();
+    for (const std::string& name : nameQueries)
+        foundInMap += map.find(name) != map.end();
+    const double mapByName = nanosSince(start) / static_cast<double>(lookups);
+
+    std::cout << "Products: " << catalog.size() << ", "
+              << catalog.memoryBytes() / catalog.size() << " bytes each\n"
+              << "Build:          " << buildMs << " ms\n"
+              << "find(id):       " << byId << " ns (" << found << " hits, sold)\n"
+              << "findByName():   " << byName << " ns (" << foundByName << " hits)\n"
+              << "unordered_map:  build " << mapBuildMs << " ms, find " << mapByName
+              << " ns (" << foundInMap << " hits)\n"
+              << "Revenue:        " << catalog.revenue() << "\n";
+
+    return foundByName == foundInMap ? 0 : 1;
+}
@@ -0,0 +1,280 @@
+/**
+ * @file concurrent_inventory.h
+ * @brief Drink inventory that many purchase threads can sell from at once.
+ */
+#pragma once
+
+#include "../common/money.h"
+#include "order.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+/* ============================================================
+   CONCURRENT INVENTORY
+   Concept: Lock-free counters, one cache line per slot
+   ============================================================ */
+
+/**
+ * @class ConcurrentInventory
+ * @brief Same interface as Inventory, safe to share between threads.
+ *
+ * Names and prices never change after construction, so they are read
+ * without synchronization. Only the stock moves: each drink has its
+ * own atomic quantity and sold counter on a private cache line, so
+ * threads selling different drinks never touch the same line.
+ *
+ * sell() takes a unit with compare-and-swap and only if one is left,
+ * so concurrent buyers can never take a quantity below zero
+ * (no overselling), whatever the interleaving.
+ *
+ * One more atomic word holds a bit per drink that is in stock, so
+ * hasStock() and inStockCount() are a single load. Only the thread
+ * whose operation takes a slot to zero or back from zero touches the
+ * word, so ordinary sells never write it.
+ */
+class ConcurrentInventory {
+private:
+    /**
+     * @struct Slot
+     * @brief Stock of one drink, padded to a cache line.
+     */
+    struct alignas(64) Slot {
+        std::atomic<int> quantity{0};
+        std::atomic<int> sold{0};
+    };
+
+    /**
+     * @struct Drink
+     * @brief Immutable description of a drink
+     */
+    struct Drink {
+        const char* name;
+        Money price;
+    };
+
+    static constexpr std::size_t kDrinks = 3;
+
+    const std::array<Drink, kDrinks> drinks{
+        Drink{"Coke",  Money::fromCents(55)},
+        Drink{"Pepsi", Money::fromCents(45)},
+        Drink{"Water", Money::fromCents(85)}
+    };
+
+    std::array<Slot, kDrinks> slots{};
+
+    static_assert(kDrinks <= 64, "one availability bit per drink");
+
+    /// Bit i set while drink i is in stock
+    alignas(64) std::atomic<std::uint64_t> available{0};
+
+    /**
+     * @brief Take `n` units from a slot unless fewer are left.
+     * @return units left afterwards, or -1 if the slot was short
+     */
+    int reserve(std::size_t index, int n) {
+        std::atomic<int>& quantity = slots[index].quantity;
+        int current = quantity.load(std::memory_order_relaxed);
+        do {
+            if (current < n)
+                return -1;
+        } while (!quantity.compare_exchange_weak(current, current - n,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed));
+        return current - n;
+    }
+
+    /**
+     * @brief Put back `n` units taken by reserve().
+     */
+    void unreserve(std::size_t index, int n) {
+        if (slots[index].quantity.fetch_add(n, std::memory_order_acq_rel) == 0)
+            syncAvailable(index);
+    }
+
+    /**
+     * @brief Make drink `index`'s bit match its quantity.
+     *
+     * Called after a slot crossed zero. Racing callers may write the
+     * bit in either order, so each one re-reads the quantity after
+     * its write and repeats until bit and quantity agree; whoever
+     * writes last has seen the latest quantity.
+     */
+    void syncAvailable(std::size_t index) {
+        const std::uint64_t bit = std::uint64_t{1} << index;
+        for (;;) {
+            const bool inStock = slots[index].quantity.load() > 0;
+            if (inStock)
+                available.fetch_or(bit);
+            else
+                available.fetch_and(~bit);
+            if ((slots[index].quantity.load() > 0) == inStock)
+                return;
+        }
+    }
+
+public:
+    /**
+     * @brief Starts every drink with `quantity` units (negative counts as 0)
+     */
+    explicit ConcurrentInventory(int quantity = 10) {
+        if (quantity < 0)
+            quantity = 0;
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            slots[i].quantity.store(quantity, std::memory_order_relaxed);
+            if (quantity > 0)
+                available.fetch_or(std::uint64_t{1} << i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Returns formatted drink menu
+     */
+    std::string menu() const {
+        std::ostringstream out;
+        out << "\nAvailable Drinks:\n";
+        for (std::size_t i = 0; i < drinks.size(); ++i) {
+            out << i << ": " << drinks[i].name
+                << " ($" << drinks[i].price << ")\n";
+        }
+        return out.str();
+    }
+
+    /**
+     * @brief Sells one unit of a drink (thread-safe, never oversells)
+     */
+    bool sell(std::size_t index) {
+        if (index >= slots.size())
+            return false;
+
+        const int left = reserve(index, 1);
+        if (left < 0)
+            return false;
+        if (left == 0)
+            syncAvailable(index);
+
+        slots[index].sold.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Sells a whole multi-item order, or nothing (thread-safe)
+     *
+     * Lines are checked first without touching any counter. Then each
+     * line reserves its units with compare-and-swap; if one is short,
+     * the lines reserved so far are put back and the order fails.
+     * No order is ever half sold and nothing is oversold; a buyer
+     * racing with a failing order may briefly see its units missing.
+     */
+    OrderResult sellBatch(OrderView order) {
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            if (order[i].index >= slots.size())
+                return {OrderStatus::InvalidItem, i};
+            if (order[i].quantity <= 0)
+                return {OrderStatus::InvalidQuantity, i};
+        }
+
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const int left = reserve(order[i].index, order[i].quantity);
+            if (left < 0) {
+                const std::size_t failed = i;
+                while (i-- > 0)
+                    unreserve(order[i].index, order[i].quantity);
+                return {OrderStatus::OutOfStock, failed};
+            }
+            if (left == 0)
+                syncAvailable(order[i].index);
+        }
+
+        for (const OrderLine& line : order)
+            slots[line.index].sold.fetch_add(line.quantity, std::memory_order_relaxed);
+        return {OrderStatus::Ok, 0};
+    }
+
+    /**
+     * @brief Adds `units` to a drink (thread-safe)
+     */
+    void restock(std::size_t index, int units) {
+        if (index < slots.size() && units > 0)
+            unreserve(index, units);
+    }
+
+    /**
+     * @brief Exact total of everything sold so far
+     */
+    Money revenue() const {
+        Money total;
+        for (std::size_t i = 0; i < drinks.size(); ++i)
+            total += drinks[i].price * sold(i);
+        return total;
+    }
+
+    /**
+     * @brief Returns drink price
+     */
+    Money price(std::size_t index) const {
+        return (index < drinks.size()) ? drinks[index].price : Money();
+    }
+
+    /**
+     * @brief Checks if any drink is available (a snapshot, O(1))
+     */
+    bool hasStock() const {
+        return available.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief Number of drinks in stock (a snapshot, O(1))
+     */
+    std::size_t inStockCount() const {
+        return static_cast<std::size_t>(
+            __builtin_popcountll(available.load(std::memory_order_acquire)));
+    }
+
+    /**
+     * @brief Calls `f(index)` for every drink in stock, O(available)
+     */
+    template <class F>
+    void forEachAvailable(F&& f) const {
+        for (std::uint64_t bits = available.load(std::memory_order_acquire); bits != 0;
+             bits &= bits - 1)
+            f(static_cast<std::size_t>(__builtin_ctzll(bits)));
+    }
+
+    /**
+     * @brief Returns remaining quantity (a snapshot)
+     */
+    int quantity(std::size_t index) const {
+        return (index < slots.size())
+                   ? slots[index].quantity.load(std::memory_order_relaxed)
+                   : -1;
+    }
+
+    /**
+     * @brief Units of a drink sold so far
+     */
+    int sold(std::size_t index) const {
+        return (index < slots.size())
+                   ? slots[index].sold.load(std::memory_order_relaxed)
+                   : 0;
+    }
+
+    /**
+     * @brief Returns drink name
+     */
+    std::string_view name(std::size_t index) const {
+        return (index < drinks.size()) ? std::string_view(drinks[index].name) : "Invalid";
+    }
+
+    /**
+     * @brief Number of selectable drinks
+     */
+    std::size_t size() const {
+        return drinks.size();
+    }
+};
@@ -0,0 +1,294 @@
+/**
+ * @file inventory.h
+ * @brief Single-threaded drink inventory of the vending machine.
+ */
+#pragma once
+
+#include "../common/money.h"
+#include "menu_cache.h"
+#include "order.h"
+#include "sales_analytics.h"
+#include "stock_journal.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/* ============================================================
+   INVENTORY
+   OOP Concept Applied: Encapsulation
+   ============================================================ */
+
+/**
+ * @class Inventory
+ * @brief Manages drinks inside the vending machine
+ */
+class Inventory {
+private:
+    /**
+     * @struct Drink
+     * @brief Represents a single drink item
+     */
+    struct Drink {
+        std::string name;
+        Money price;
+        int quantity;
+        int sold;
+    };
+
+    static constexpr std::size_t kDrinks = 3;
+
+    /// Fixed-size inventory
+    std::array<Drink, kDrinks> drinks{
+        Drink{"Coke",  Money::fromCents(55), 10, 0},
+        Drink{"Pepsi", Money::fromCents(45), 10, 0},
+        Drink{"Water", Money::fromCents(85), 10, 0}
+    };
+
+    /// Bit i set while drink i is in stock (all start full)
+    std::uint32_t available = (1u << kDrinks) - 1;
+
+    /// Rendered menu, patched by sell()
+    mutable MenuCache menuCache;
+
+    /// Optional write-ahead log of every stock change (not owned)
+    StockJournal* journal = nullptr;
+
+    /// Optional sales statistics (not owned)
+    SalesAnalytics* analytics = nullptr;
+
+    /**
+     * @brief Snapshot the journal once its log is full.
+     */
+    void checkpoint() {
+        if (journal->needsSnapshot())
+            journal->snapshot(*this);
+    }
+
+public:
+    Inventory() = default;
+
+    /**
+     * @brief Starts every drink with `quantity` units (negative counts as 0)
+     */
+    explicit Inventory(int quantity) {
+        if (quantity < 0)
+            quantity = 0;
+        for (auto& d : drinks)
+            d.quantity = quantity;
+        if (quantity == 0)
+            available = 0;
+    }
+
+    /**
+     * @brief Returns formatted drink menu (cached, valid until the next sell)
+     */
+    std::string_view menu() const {
+        return menuCache.render(*this);
+    }
+
+    /**
+     * @brief Sells one unit of a drink
+     */
+    bool sell(std::size_t index) {
+        if (index >= drinks.size() || drinks[index].quantity <= 0)
+            return false;
+
+        if (--drinks[index].quantity <= 0)
+            available &= ~(1u << index);
+        ++drinks[index].sold;
+        menuCache.markDirty(index);
+        if (analytics)
+            analytics->record(index);
+        if (journal) {
+            journal->appendSell(index);
+            checkpoint();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Sells a whole multi-item order, or nothing
+     *
+     * One pass adds up the units wanted per drink (an order may name
+     * a drink twice) and checks each line; only a fully valid order
+     * touches the stock, in a second pass.
+     */
+    OrderResult sellBatch(OrderView order) {
+        std::array<int, kDrinks> wanted{};
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const OrderLine& line = order[i];
+            if (line.index >= drinks.size())
+                return {OrderStatus::InvalidItem, i};
+            if (line.quantity <= 0)
+                return {OrderStatus::InvalidQuantity, i};
+            if (line.quantity > drinks[line.index].quantity - wanted[line.index])
+                return {OrderStatus::OutOfStock, i};
+            wanted[line.index] += line.quantity;
+        }
+
+        std::array<OrderLine, kDrinks> lines;
+        std::size_t count = 0;
+        for (std::size_t d = 0; d < drinks.size(); ++d) {
+            if (wanted[d] == 0)
+                continue;
+            if ((drinks[d].quantity -= wanted[d]) <= 0)
+                available &= ~(1u << d);
+            drinks[d].sold += wanted[d];
+            menuCache.markDirty(d);
+            lines[count++] = {d, wanted[d]};
+            if (analytics)
+                analytics->record(d, wanted[d]);
+        }
+
+        if (journal) {
+            // An order that does not fit the log is covered by the snapshot
+            if (journal->fits(count))
+                journal->appendOrder(OrderView(lines.data(), count));
+            else
+                journal->snapshot(*this);
+            checkpoint();
+        }
+        return {OrderStatus::Ok, 0};
+    }
+
+    /**
+     * @brief Adds `units` to a drink
+     */
+    void restock(std::size_t index, int units) {
+        if (index >= drinks.size() || units <= 0)
+            return;
+        if (drinks[index].quantity <= 0)
+            available |= 1u << index;
+        drinks[index].quantity += units;
+        menuCache.markDirty(index);
+        if (journal) {
+            journal->appendRestock(index, units);
+            checkpoint();
+        }
+    }
+
+    /**
+     * @brief Overwrites a drink's counters (used when loading a snapshot)
+     */
+    void setStock(std::size_t index, int quantity, int sold) {
+        if (index >= drinks.size())
+            return;
+        drinks[index].quantity = quantity > 0 ? quantity : 0;
+        drinks[index].sold = sold;
+        if (quantity > 0)
+            available |= 1u << index;
+        else
+            available &= ~(1u << index);
+        menuCache.markDirty(index);
+    }
+
+    /**
+     * @brief Recover the stock from a journal and log every change to it.
+     *
+     * If the journal already holds history, the quantities and sales
+     * are rebuilt from it; a fresh journal starts with a snapshot of
+     * the current stock.
+     */
+    void attachJournal(StockJournal& j) {
+        // Replay must neither log itself again nor count as new sales
+        SalesAnalytics* live = analytics;
+        journal = nullptr;
+        analytics = nullptr;
+        if (!j.recover(*this))
+            j.snapshot(*this);
+        journal = &j;
+        analytics = live;
+
+        // A crash right after the last record fit leaves a full log
+        checkpoint();
+    }
+
+    /**
+     * @brief Feed every sale from now on into `a` (one writer: this inventory)
+     */
+    void attachAnalytics(SalesAnalytics& a) {
+        if (a.size() < drinks.size())
+            throw std::invalid_argument("Analytics sized for fewer drinks.");
+        analytics = &a;
+    }
+
+    /**
+     * @brief Force logged changes to disk (before replying to a customer)
+     */
+    void flushJournal() {
+        if (journal)
+            journal->flush();
+    }
+
+    /**
+     * @brief Exact total of everything sold so far
+     */
+    Money revenue() const {
+        Money total;
+        for (const auto& d : drinks)
+            total += d.price * d.sold;
+        return total;
+    }
+
+    /**
+     * @brief Returns drink price
+     */
+    Money price(std::size_t index) const {
+        return (index < drinks.size()) ? drinks[index].price : Money();
+    }
+
+    /**
+     * @brief Checks if any drink is available, O(1)
+     */
+    bool hasStock() const {
+        return available != 0;
+    }
+
+    /**
+     * @brief Number of drinks in stock, O(1)
+     */
+    std::size_t inStockCount() const {
+        return static_cast<std::size_t>(__builtin_popcount(available));
+    }
+
+    /**
+     * @brief Calls `f(index)` for every drink in stock, O(available)
+     */
+    template <class F>
+    void forEachAvailable(F&& f) const {
+        for (std::uint32_t bits = available; bits != 0; bits &= bits - 1)
+            f(static_cast<std::size_t>(__builtin_ctz(bits)));
+    }
+
+    /**
+     * @brief Returns remaining quantity
+     */
+    int quantity(std::size_t index) const {
+        return (index < drinks.size()) ? drinks[index].quantity : -1;
+    }
+
+    /**
+     * @brief Units sold so far
+     */
+    int sold(std::size_t index) const {
+        return (index < drinks.size()) ? drinks[index].sold : 0;
+    }
+
+    /**
+     * @brief Returns drink name
+     */
+    std::string_view name(std::size_t index) const {
+        return (index < drinks.size()) ? std::string_view(drinks[index].name) : "Invalid";
+    }
+
+    /**
+     * @brief Number of selectable drinks
+     */
+    std::size_t size() const {
+        return drinks.size();
+    }
+};
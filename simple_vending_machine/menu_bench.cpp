@@ -0,0 +1,124 @@
+/**
+ * @file menu_bench.cpp
+ * @brief Cost of showing the menu: fresh ostringstream vs MenuCache.
+ *
+ * @details
+ * Replays the loop of the vending machine - show the menu, sell one
+ * unit - and times the menu part two ways:
+ *
+ * - stream : the old menu(), a new std::ostringstream and std::string
+ *            per call
+ * - cached : MenuCache::render(), which patches only the line of the
+ *            drink just sold
+ *
+ * Once with the three drinks of Inventory and once with a
+ * ProductCatalog of `products` items. Heap allocations are counted by
+ * replacing the global operator new.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 menu_bench.cpp -o menu_bench
+ * ./menu_bench [iterations] [products]      (default: 200000 2000)
+ */
+
+#include "inventory.h"
+#include "menu_cache.h"
+#include "product_catalog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+/* ---------- allocation counter ---------- */
+
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief The menu as it was built before MenuCache
+ */
+template <class Catalog>
+std::string streamMenu(const Catalog& catalog) {
+    std::ostringstream out;
+    out << "\nAvailable Drinks:\n";
+    for (std::size_t i = 0; i < catalog.size(); ++i) {
+        out << i << ": " << catalog.name(i)
+            << " ($" << catalog.price(i) << ")\n";
+    }
+    return out.str();
+}
+
+/**
+ * @brief Times `iterations` x (menu + sell one unit) in both modes.
+ */
+template <class Catalog>
+void compare(const char* label, Catalog stream, Catalog cached, long iterations) {
+    std::size_t bytes = 0;
+
+    std::size_t before = g_allocations;
+    auto start = Clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        bytes += streamMenu(stream).size();
+        stream.sell(static_cast<std::size_t>(i) % stream.size());
+    }
+    std::chrono::duration<double, std::nano> streamTime = Clock::now() - start;
+    const std::size_t streamAllocs = g_allocations - before;
+
+    MenuCache menu;
+    menu.render(cached);  // first render sizes the buffers
+
+    before = g_allocations;
+    start = Clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        bytes += menu.render(cached).size();
+        const std::size_t index = static_cast<std::size_t>(i) % cached.size();
+        cached.sell(index);
+        menu.markDirty(index);
+    }
+    std::chrono::duration<double, std::nano> cachedTime = Clock::now() - start;
+    const std::size_t cachedAllocs = g_allocations - before;
+
+    std::cout << label << ":\n"
+              << "  stream: " << streamTime.count() / iterations << " ns/menu, "
+              << static_cast<double>(streamAllocs) / iterations << " allocs/menu\n"
+              << "  cached: " << cachedTime.count() / iterations << " ns/menu, "
+              << static_cast<double>(cachedAllocs) / iterations << " allocs/menu\n"
+              << "  (" << bytes / 1024 << " KiB rendered)\n";
+}
+
+int main(int argc, char* argv[]) {
+
+    long iterations = (argc > 1) ? std::atol(argv[1]) : 200'000L;
+    std::size_t products = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 2'000;
+
+    compare("Inventory (3 drinks)", Inventory(1'000'000), Inventory(1'000'000), iterations);
+
+    ProductCatalog catalog;
+    for (std::size_t i = 0; i < products; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "product-%05zu", i);
+        catalog.add(i, name, Money::fromCents(50 + static_cast<long>(i % 400)), 1000);
+    }
+    compare("ProductCatalog", catalog, catalog, iterations / 100);
+
+    return 0;
+}
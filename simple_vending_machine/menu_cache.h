@@ -0,0 +1,238 @@
+/**
+ * @file menu_cache.h
+ * @brief Rendered menu text, rebuilt on catalog changes and patched per line.
+ */
+#pragma once
+
+#include "../common/money.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/* ============================================================
+   MENU CACHE
+   Concept: Caching + incremental update
+   ============================================================ */
+
+/**
+ * @class MenuCache
+ * @brief Keeps the menu text of a catalog ready to print.
+ *
+ * Works with any catalog that offers size(), name(i), price(i) and
+ * quantity(i) (Inventory, ConcurrentInventory, ProductCatalog).
+ *
+ * Every line has the same fixed layout, sized at the last rebuild:
+ *
+ *   "  3: Water     $0.85    9 left\n"
+ *
+ * so a changed price or stock is patched by rewriting that one line
+ * in place. markDirty() only queues the line; render() applies all
+ * queued patches, so many sells between two renders cost one patch
+ * per line. A full rebuild happens only when the number of products
+ * changes, invalidate() is called, or a new value no longer fits its
+ * column.
+ *
+ * Text is written digit by digit into one reused std::string - no
+ * streams, no temporaries - so once the buffers have grown to size,
+ * render() allocates nothing.
+ */
+class MenuCache {
+
+private:
+
+    std::string header_;
+    std::string text_;
+
+    std::size_t lines_{0};
+    std::size_t lineLength_{0};
+    bool valid_{false};
+
+    std::vector<std::uint32_t> dirty_;
+    std::vector<char> queued_;
+
+    /* ---------- column widths ---------- */
+    std::size_t indexWidth_{1};
+    std::size_t nameWidth_{0};
+    std::size_t priceWidth_{0};
+    std::size_t stockWidth_{0};
+
+    static constexpr std::size_t kStockSuffix = 5;  // " left"
+
+    /**
+     * @brief Writes `value` right-aligned in `width` chars ending at `end`.
+     * @return characters used
+     */
+    static std::size_t writeNumber(char* end, std::size_t width, std::uint64_t value) {
+        std::size_t used = 0;
+        do {
+            *--end = static_cast<char>('0' + value % 10);
+            value /= 10;
+            ++used;
+        } while (value != 0 && used < width);
+        return used;
+    }
+
+    static std::size_t digits(std::uint64_t value) {
+        std::size_t n = 1;
+        while (value >= 10) {
+            value /= 10;
+            ++n;
+        }
+        return n;
+    }
+
+    /// Characters of "$12.34" / "-$0.05"
+    static std::size_t priceLength(Money price) {
+        const Money::Rep c = price.cents();
+        const std::uint64_t abs = static_cast<std::uint64_t>(c < 0 ? -c : c);
+        return (c < 0 ? 1 : 0) + 1 + digits(abs / 100) + 3;
+    }
+
+    /**
+     * @brief Writes a price right-aligned in `width` chars ending at `end`.
+     */
+    static void writePrice(char* end, std::size_t width, Money price) {
+        const Money::Rep c = price.cents();
+        const std::uint64_t abs = static_cast<std::uint64_t>(c < 0 ? -c : c);
+        char* p = end;
+        *--p = static_cast<char>('0' + abs % 10);
+        *--p = static_cast<char>('0' + abs / 10 % 10);
+        *--p = '.';
+        p -= writeNumber(p, width, abs / 100);
+        *--p = '$';
+        if (c < 0)
+            *--p = '-';
+        std::memset(end - width, ' ', static_cast<std::size_t>(p - (end - width)));
+    }
+
+    /**
+     * @brief Writes line `i` into its slot of the buffer.
+     * @return false if a value no longer fits its column
+     */
+    template <class Catalog>
+    bool writeLine(const Catalog& catalog, std::size_t i) {
+        const std::string_view name = catalog.name(i);
+        const Money price = catalog.price(i);
+        const int quantity = catalog.quantity(i);
+
+        if (name.size() > nameWidth_ || priceLength(price) > priceWidth_ ||
+            (quantity > 0 && digits(static_cast<std::uint64_t>(quantity)) > stockWidth_))
+            return false;
+
+        char* line = &text_[header_.size() + i * lineLength_];
+        char* p = line;
+
+        // "  3: "
+        std::memset(p, ' ', indexWidth_);
+        writeNumber(p + indexWidth_, indexWidth_, i);
+        p += indexWidth_;
+        *p++ = ':';
+        *p++ = ' ';
+
+        // "Water     "
+        std::memcpy(p, name.data(), name.size());
+        std::memset(p + name.size(), ' ', nameWidth_ - name.size());
+        p += nameWidth_;
+        *p++ = ' ';
+
+        // "$0.85"
+        writePrice(p + priceWidth_, priceWidth_, price);
+        p += priceWidth_;
+        *p++ = ' ';
+
+        // "   9 left" / "sold out"
+        const std::size_t stock = stockWidth_ + kStockSuffix;
+        std::memset(p, ' ', stock);
+        if (quantity > 0) {
+            writeNumber(p + stockWidth_, stockWidth_, static_cast<std::uint64_t>(quantity));
+            std::memcpy(p + stockWidth_, " left", kStockSuffix);
+        } else {
+            std::memcpy(p + stock - 8, "sold out", 8);
+        }
+        p += stock;
+        *p = '\n';
+        return true;
+    }
+
+public:
+
+    explicit MenuCache(std::string header = "\nAvailable Drinks:\n")
+        : header_(std::move(header)) {}
+
+    /**
+     * @brief Re-renders every line, sizing the columns to fit.
+     */
+    template <class Catalog>
+    void rebuild(const Catalog& catalog) {
+        lines_ = catalog.size();
+
+        indexWidth_ = digits(lines_ > 0 ? lines_ - 1 : 0);
+        nameWidth_ = 0;
+        priceWidth_ = 5;  // "$0.00"
+        int maxQuantity = 0;
+        for (std::size_t i = 0; i < lines_; ++i) {
+            nameWidth_ = std::max(nameWidth_, catalog.name(i).size());
+            priceWidth_ = std::max(priceWidth_, priceLength(catalog.price(i)));
+            maxQuantity = std::max(maxQuantity, catalog.quantity(i));
+        }
+        // Leave room for restocks up to 10x before a rebuild is needed
+        stockWidth_ = std::max<std::size_t>(3, digits(static_cast<std::uint64_t>(maxQuantity)) + 1);
+
+        lineLength_ = indexWidth_ + 2 + nameWidth_ + 1 + priceWidth_ + 1 +
+                      stockWidth_ + kStockSuffix + 1;
+
+        text_.assign(header_);
+        text_.resize(header_.size() + lines_ * lineLength_);
+        for (std::size_t i = 0; i < lines_; ++i)
+            writeLine(catalog, i);
+
+        dirty_.clear();
+        queued_.assign(lines_, 0);
+        valid_ = true;
+    }
+
+    /**
+     * @brief Queues line `index` to be re-rendered on the next render().
+     */
+    void markDirty(std::size_t index) {
+        if (!valid_ || index >= lines_ || queued_[index])
+            return;
+        queued_[index] = 1;
+        dirty_.push_back(static_cast<std::uint32_t>(index));
+    }
+
+    /**
+     * @brief Forces a full rebuild on the next render().
+     */
+    void invalidate() {
+        valid_ = false;
+    }
+
+    /**
+     * @brief The up-to-date menu text (valid until the next change).
+     */
+    template <class Catalog>
+    std::string_view render(const Catalog& catalog) {
+        if (!valid_ || catalog.size() != lines_) {
+            rebuild(catalog);
+            return text_;
+        }
+
+        bool fits = true;
+        for (std::uint32_t i : dirty_) {
+            queued_[i] = 0;
+            fits = fits && writeLine(catalog, i);
+        }
+        dirty_.clear();
+
+        if (!fits)
+            rebuild(catalog);
+        return text_;
+    }
+};
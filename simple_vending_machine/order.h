@@ -0,0 +1,79 @@
+/**
+ * @file order.h
+ * @brief Multi-item orders for the batch purchase API (sellBatch).
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/* ============================================================
+   ORDERS
+   Concept: Value types + all-or-nothing results
+   ============================================================ */
+
+/**
+ * @struct OrderLine
+ * @brief `quantity` units of the product at `index`.
+ */
+struct OrderLine {
+    std::size_t index;
+    int quantity;
+};
+
+/**
+ * @enum OrderStatus
+ * @brief Outcome of a whole order.
+ */
+enum class OrderStatus {
+    Ok,
+    InvalidItem,       ///< no product at that index
+    InvalidQuantity,   ///< quantity <= 0
+    OutOfStock         ///< not enough units left
+};
+
+inline const char* toString(OrderStatus status) {
+    switch (status) {
+    case OrderStatus::Ok:              return "Ok";
+    case OrderStatus::InvalidItem:     return "InvalidItem";
+    case OrderStatus::InvalidQuantity: return "InvalidQuantity";
+    case OrderStatus::OutOfStock:      return "OutOfStock";
+    }
+    return "Unknown";
+}
+
+/**
+ * @struct OrderResult
+ * @brief Status of an order and, if it failed, the first bad line.
+ */
+struct OrderResult {
+    OrderStatus status;
+    std::size_t line;   ///< index into the order; meaningless when ok()
+
+    bool ok() const {
+        return status == OrderStatus::Ok;
+    }
+};
+
+/**
+ * @class OrderView
+ * @brief Read-only view of contiguous order lines (a C++17 span).
+ */
+class OrderView {
+public:
+    OrderView(const OrderLine* lines, std::size_t size) : lines_(lines), size_(size) {}
+
+    OrderView(const std::vector<OrderLine>& lines) : lines_(lines.data()), size_(lines.size()) {}
+
+    template <std::size_t N>
+    OrderView(const OrderLine (&lines)[N]) : lines_(lines), size_(N) {}
+
+    const OrderLine* begin() const { return lines_; }
+    const OrderLine* end() const { return lines_ + size_; }
+    const OrderLine& operator[](std::size_t i) const { return lines_[i]; }
+    std::size_t size() const { return size_; }
+
+private:
+    const OrderLine* lines_;
+    std::size_t size_;
+};
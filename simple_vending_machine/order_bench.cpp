@@ -0,0 +1,146 @@
+/**
+ * @file order_bench.cpp
+ * @brief Multi-item orders: N sell() calls vs one sellBatch().
+ *
+ * @details
+ * 1. Single-threaded, for Inventory and for a ProductCatalog of
+ *    `products` items: orders of `lines` random items, sold once as
+ *    one sell() per unit and once as one sellBatch() per order.
+ *    Reports ns per unit sold.
+ * 2. Concurrent: 1, 2, 4, ... N threads send orders of one unit of
+ *    every drink to one ConcurrentInventory until it runs dry.
+ *    Because orders are all-or-nothing, every drink must end with the
+ *    same number sold, equal to the units the threads counted, and no
+ *    quantity may go below zero.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 -pthread order_bench.cpp -o order_bench
+ * ./order_bench [orders] [lines] [products] [max_threads]
+ *               (default: 1000000 4 1000000 cores)
+ */
+
+#include "concurrent_inventory.h"
+#include "inventory.h"
+#include "order.h"
+#include "product_catalog.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief ns per unit: one sell() per unit vs one sellBatch() per order.
+ */
+template <class Catalog>
+void compare(const char* label, Catalog single, Catalog batch,
+             const std::vector<OrderLine>& lines, std::size_t perOrder) {
+    const std::size_t orders = lines.size() / perOrder;
+
+    long units = 0;
+    auto start = Clock::now();
+    for (const OrderLine& line : lines) {
+        for (int q = 0; q < line.quantity; ++q)
+            units += single.sell(line.index);
+    }
+    std::chrono::duration<double, std::nano> singleTime = Clock::now() - start;
+
+    long batchUnits = 0;
+    start = Clock::now();
+    for (std::size_t o = 0; o < orders; ++o) {
+        OrderView order(lines.data() + o * perOrder, perOrder);
+        if (batch.sellBatch(order).ok()) {
+            for (const OrderLine& line : order)
+                batchUnits += line.quantity;
+        }
+    }
+    std::chrono::duration<double, std::nano> batchTime = Clock::now() - start;
+
+    std::cout << label << ":\n"
+              << "  sell():      " << singleTime.count() / static_cast<double>(units)
+              << " ns/unit (" << units << " units)\n"
+              << "  sellBatch(): " << batchTime.count() / static_cast<double>(batchUnits)
+              << " ns/unit (" << batchUnits << " units)\n";
+}
+
+std::vector<OrderLine> randomOrders(std::size_t orders, std::size_t perOrder,
+                                    std::size_t items, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<OrderLine> lines(orders * perOrder);
+    for (OrderLine& line : lines)
+        line = {rng() % items, 1 + static_cast<int>(rng() % 2)};
+    return lines;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t orders = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    std::size_t perOrder = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 4;
+    std::size_t products = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 1'000'000;
+    unsigned hw = std::thread::hardware_concurrency();
+    int maxThreads = (argc > 4) ? std::atoi(argv[4]) : static_cast<int>(hw ? hw : 4);
+    if (perOrder == 0)
+        perOrder = 1;
+
+    // 1. Single-threaded
+    {
+        const std::vector<OrderLine> lines = randomOrders(orders, perOrder, 3, 1);
+        const int stock = static_cast<int>(orders * perOrder);
+        compare("Inventory", Inventory(stock), Inventory(stock), lines, perOrder);
+    }
+    {
+        ProductCatalog catalog;
+        catalog.reserve(products);
+        for (std::size_t i = 0; i < products; ++i)
+            catalog.add(i, "product-" + std::to_string(i), Money::fromCents(100), 1'000);
+        const std::vector<OrderLine> lines = randomOrders(orders, perOrder, products, 2);
+        compare("ProductCatalog", catalog, catalog, lines, perOrder);
+    }
+
+    // 2. Concurrent, all-or-nothing check
+    const OrderLine oneOfEach[] = {{0, 1}, {1, 1}, {2, 1}};
+    const int stock = static_cast<int>(orders / 2);
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ConcurrentInventory inventory(stock);
+        std::atomic<long> units{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> buyers;
+
+        for (int t = 0; t < threads; ++t) {
+            buyers.emplace_back([&] {
+                long mine = 0;
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                while (inventory.sellBatch(oneOfEach).ok())
+                    mine += 3;
+                units += mine;
+            });
+        }
+
+        auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread& b : buyers)
+            b.join();
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        const bool consistent = inventory.sold(0) == stock && inventory.sold(1) == stock &&
+                                inventory.sold(2) == stock && units.load() == 3L * stock &&
+                                inventory.quantity(0) == 0 && inventory.quantity(1) == 0 &&
+                                inventory.quantity(2) == 0;
+
+        std::cout << threads << " thread(s): "
+                  << static_cast<long>(stock / elapsed.count()) << " orders/s"
+                  << ", " << (consistent ? "all-or-nothing held" : "ORDER SPLIT OR OVERSOLD")
+                  << "\n";
+        if (!consistent)
+            return 1;
+    }
+
+    return 0;
+}
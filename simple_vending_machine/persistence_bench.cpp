@@ -0,0 +1,191 @@
+/**
+ * @file persistence_bench.cpp
+ * @brief Cost of journaling stock changes and time to warm-start.
+ *
+ * @details
+ * 1. Inventory: `sales` journaled sells, with an order every 8th and
+ *    a restock every 1000th purchase. Reports ns per change with and
+ *    without the journal, then "restarts": a new Inventory attaches
+ *    to the same directory, and the time to recover and whether the
+ *    recovered stock matches are reported.
+ * 2. The same for a ProductCatalog of `products` SKUs, where the
+ *    snapshot is megabytes and each snapshot write shows up.
+ *
+ * Restart time must not grow with `sales`: recovery loads one
+ * snapshot and replays at most `capacity` log records.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 persistence_bench.cpp -o persistence_bench
+ * ./persistence_bench [state_dir] [sales] [products] [capacity]
+ *                     (default: persistence_bench.state 30000000 1000000 262144)
+ */
+
+#include "inventory.h"
+#include "order.h"
+#include "product_catalog.h"
+#include "stock_journal.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void clear(const std::string& dir) {
+    ::unlink((dir + "/stock.wal").c_str());
+    ::unlink((dir + "/stock.snap").c_str());
+}
+
+template <class Catalog>
+bool sameStock(const Catalog& a, const Catalog& b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a.quantity(i) != b.quantity(i) || a.sold(i) != b.sold(i))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief The purchase mix, applied to an Inventory with or without journal.
+ */
+long shop(Inventory& inventory, long sales) {
+    std::mt19937 rng(7);
+    long changes = 0;
+    for (long s = 0; s < sales; ++s) {
+        const std::size_t drink = rng() % 3;
+        if (s % 8 == 0) {
+            const OrderLine order[] = {{drink, 2}, {(drink + 1) % 3, 1}};
+            inventory.sellBatch(order);
+        } else {
+            inventory.sell(drink);
+        }
+        if (s % 1000 == 0)
+            inventory.restock(drink, 500);
+        ++changes;
+    }
+    return changes;
+}
+
+ProductCatalog makeCatalog(std::size_t products) {
+    ProductCatalog catalog;
+    catalog.reserve(products);
+    for (std::size_t i = 0; i < products; ++i)
+        catalog.add(i, "product-" + std::to_string(i), Money::fromCents(100), 1'000);
+    return catalog;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string dir = (argc > 1) ? argv[1] : "persistence_bench.state";
+    long sales = (argc > 2) ? std::atol(argv[2]) : 30'000'000;
+    std::size_t products = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 1'000'000;
+    std::size_t capacity = (argc > 4) ? std::strtoul(argv[4], nullptr, 10) : 1 << 18;
+
+    try {
+        // 1. Inventory
+        {
+            const int stock = static_cast<int>(sales);
+
+            Inventory plain(stock);
+            auto start = Clock::now();
+            shop(plain, sales);
+            const double plainMs = millisSince(start);
+
+            clear(dir);
+            Inventory original(stock);
+            double journaledMs;
+            std::uint64_t records;
+            {
+                StockJournal journal(dir, capacity);
+                original.attachJournal(journal);
+                start = Clock::now();
+                shop(original, sales);
+                original.flushJournal();
+                journaledMs = millisSince(start);
+                records = journal.sequence();
+            }
+
+            start = Clock::now();
+            Inventory recovered(stock);
+            StockJournal journal(dir);
+            recovered.attachJournal(journal);
+            const double restartMs = millisSince(start);
+
+            std::cout << "Inventory: " << sales << " purchases, " << records
+                      << " log records\n"
+                      << "  no journal: " << plainMs * 1e6 / static_cast<double>(sales)
+                      << " ns/purchase, journaled: "
+                      << journaledMs * 1e6 / static_cast<double>(sales) << " ns/purchase\n"
+                      << "  restart: " << restartMs << " ms, replayed "
+                      << journal.logged() << " records ("
+                      << (sameStock(original, recovered) ? "stock matches" : "STOCK DIFFERS")
+                      << ")\n";
+            if (!sameStock(original, recovered))
+                return 1;
+        }
+
+        // 2. ProductCatalog
+        {
+            clear(dir);
+            ProductCatalog original = makeCatalog(products);
+            long snapshots = 0;
+            double journaledMs;
+            {
+                StockJournal journal(dir, capacity);
+                if (!journal.recover(original))
+                    journal.snapshot(original);
+
+                std::mt19937 rng(11);
+                auto start = Clock::now();
+                for (long s = 0; s < sales; ++s) {
+                    const std::size_t i = rng() % products;
+                    if (original.sell(i))
+                        journal.appendSell(i);
+                    else {
+                        original.restock(i, 1'000);
+                        journal.appendRestock(i, 1'000);
+                    }
+                    if (journal.needsSnapshot()) {
+                        journal.snapshot(original);
+                        ++snapshots;
+                    }
+                }
+                journal.flush();
+                journaledMs = millisSince(start);
+            }
+
+            ProductCatalog recovered = makeCatalog(products);
+            auto start = Clock::now();
+            StockJournal journal(dir);
+            journal.recover(recovered);
+            const double restartMs = millisSince(start);
+
+            std::cout << "ProductCatalog: " << products << " SKUs, " << sales << " sales, "
+                      << snapshots << " snapshots\n"
+                      << "  journaled: " << journaledMs * 1e6 / static_cast<double>(sales)
+                      << " ns/sale (snapshots included)\n"
+                      << "  restart: " << restartMs << " ms, replayed "
+                      << journal.logged() << " records ("
+                      << (sameStock(original, recovered) ? "stock matches" : "STOCK DIFFERS")
+                      << ")\n";
+            if (!sameStock(original, recovered))
+                return 1;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[EXCEPTION] " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
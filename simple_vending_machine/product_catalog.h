@@ -0,0 +1,407 @@
+/**
+ * @file product_catalog.h
+ * @brief Catalog for millions of SKUs: flat arrays + open-addressing indexes.
+ */
+#pragma once
+
+#include "../common/money.h"
+#include "order.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* ============================================================
+   PRODUCT CATALOG
+   Concept: Structure of arrays + open addressing
+   ============================================================ */
+
+/**
+ * @class ProductCatalog
+ * @brief Products addressed by a dense index, found by SKU id or name.
+ *
+ * Storage is a structure of arrays: ids, prices, quantities and sold
+ * counts each live in their own dense std::vector, and every name is
+ * a slice of one shared string arena. A product is just its index
+ * into those arrays, so the index-based calls (sell, price, name...)
+ * mirror Inventory.
+ *
+ * find() and findByName() go through two open-addressing hash tables
+ * (linear probing, power-of-two size, at most half full) that store
+ * product indexes; name cells also carry 32 bits of the name hash so
+ * a probe only reads the arena on a likely match. A lookup hashes the
+ * key, walks a few adjacent cells and compares against the arrays -
+ * O(1) on average, with no allocation and no string copies.
+ *
+ * name() returns a std::string_view into the arena, valid until the
+ * next add().
+ *
+ * Products are only ever added, never removed, so the tables need no
+ * tombstones.
+ *
+ * Availability is kept up to date as stock crosses zero: a count of
+ * products in stock (hasStock() is O(1)) and a two-level bitmap - one
+ * bit per product, plus one bit per non-empty 64-product word - so
+ * forEachAvailable() skips sold-out regions 4096 products at a time.
+ */
+class ProductCatalog {
+
+public:
+
+    using Sku = std::uint64_t;
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+
+    /**
+     * @struct NameRef
+     * @brief Where a name lives in the arena (one load for both fields).
+     */
+    struct NameRef {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    /* ---------- structure of arrays ---------- */
+    std::vector<Sku> ids_;
+    std::vector<Money> prices_;
+    std::vector<int> quantities_;
+    std::vector<int> sold_;
+    std::vector<NameRef> nameRefs_;
+    std::string names_;
+
+    /* ---------- hash indexes: product index + 1, 0 = empty ---------- */
+    std::vector<std::uint32_t> byId_;
+
+    /// High 32 bits: tag from the name hash, low 32 bits: index + 1
+    std::vector<std::uint64_t> byName_;
+
+    /* ---------- availability ---------- */
+    std::size_t inStock_{0};
+    std::vector<std::uint64_t> availableBits_;    ///< bit per product
+    std::vector<std::uint64_t> availableWords_;   ///< bit per non-zero availableBits_ word
+
+    void markAvailable(std::size_t index) {
+        const std::size_t word = index / 64;
+        availableBits_[word] |= std::uint64_t{1} << (index % 64);
+        availableWords_[word / 64] |= std::uint64_t{1} << (word % 64);
+        ++inStock_;
+    }
+
+    void markSoldOut(std::size_t index) {
+        const std::size_t word = index / 64;
+        availableBits_[word] &= ~(std::uint64_t{1} << (index % 64));
+        if (availableBits_[word] == 0)
+            availableWords_[word / 64] &= ~(std::uint64_t{1} << (word % 64));
+        --inStock_;
+    }
+
+    static std::uint64_t hashId(Sku id) {
+        // splitmix64 finalizer: sequential ids spread over the table
+        id ^= id >> 30;
+        id *= 0xbf58476d1ce4e5b9ULL;
+        id ^= id >> 27;
+        id *= 0x94d049bb133111ebULL;
+        return id ^ (id >> 31);
+    }
+
+    static std::uint64_t hashName(std::string_view name) {
+        std::uint64_t h = 14695981039346656037ULL;
+        for (char c : name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ULL;
+        }
+        return h ^ (h >> 32);
+    }
+
+    std::size_t mask() const {
+        return byId_.size() - 1;
+    }
+
+    std::size_t idCell(Sku id) const {
+        std::size_t cell = hashId(id) & mask();
+        while (byId_[cell] != 0 && ids_[byId_[cell] - 1] != id)
+            cell = (cell + 1) & mask();
+        return cell;
+    }
+
+    static std::uint64_t tag(std::uint64_t hash) {
+        return hash & 0xFFFFFFFF00000000ULL;
+    }
+
+    std::size_t nameCell(std::string_view name, std::uint64_t hash) const {
+        std::size_t cell = hash & mask();
+        while (byName_[cell] != 0) {
+            const std::uint64_t entry = byName_[cell];
+            // The tag rejects almost every other name without touching the arena
+            if ((entry & 0xFFFFFFFF00000000ULL) == tag(hash) &&
+                this->name(static_cast<std::uint32_t>(entry) - 1) == name)
+                break;
+            cell = (cell + 1) & mask();
+        }
+        return cell;
+    }
+
+    /**
+     * @brief Rebuild both tables with `cells` cells (a power of two).
+     */
+    void rehash(std::size_t cells) {
+        byId_.assign(cells, 0);
+        byName_.assign(cells, 0);
+        for (std::size_t i = 0; i < ids_.size(); ++i) {
+            byId_[idCell(ids_[i])] = static_cast<std::uint32_t>(i + 1);
+            const std::uint64_t hash = hashName(name(i));
+            byName_[nameCell(name(i), hash)] = tag(hash) | (i + 1);
+        }
+    }
+
+    static std::size_t cellsFor(std::size_t products) {
+        std::size_t cells = 16;
+        while (cells < 2 * products)
+            cells *= 2;
+        return cells;
+    }
+
+public:
+
+    ProductCatalog() {
+        rehash(cellsFor(0));
+    }
+
+    /**
+     * @brief Make room for `products` products and `nameBytes` of names.
+     */
+    void reserve(std::size_t products, std::size_t nameBytes = 0) {
+        ids_.reserve(products);
+        prices_.reserve(products);
+        quantities_.reserve(products);
+        sold_.reserve(products);
+        nameRefs_.reserve(products);
+        names_.reserve(nameBytes);
+        availableBits_.reserve(products / 64 + 1);
+        availableWords_.reserve(products / 4096 + 1);
+        if (cellsFor(products) > byId_.size())
+            rehash(cellsFor(products));
+    }
+
+    /**
+     * @brief Adds a product.
+     * @return its index
+     *
+     * Throws std::invalid_argument if the SKU id or the name is taken.
+     */
+    std::size_t add(Sku id, std::string_view name, Money price, int quantity) {
+        if (find(id) != npos)
+            throw std::invalid_argument("Duplicate SKU " + std::to_string(id) + ".");
+        if (findByName(name) != npos)
+            throw std::invalid_argument("Duplicate product name '" + std::string(name) + "'.");
+        if (quantity < 0)
+            throw std::invalid_argument("Negative quantity.");
+        if (ids_.size() >= UINT32_MAX - 1 || names_.size() + name.size() > UINT32_MAX)
+            throw std::length_error("Product catalog is full.");
+
+        if (cellsFor(ids_.size() + 1) > byId_.size())
+            rehash(byId_.size() * 2);
+
+        const std::uint64_t hash = hashName(name);
+        const std::size_t index = ids_.size();
+
+        ids_.push_back(id);
+        prices_.push_back(price);
+        quantities_.push_back(quantity);
+        sold_.push_back(0);
+        nameRefs_.push_back({static_cast<std::uint32_t>(names_.size()),
+                             static_cast<std::uint32_t>(name.size())});
+        names_.append(name.data(), name.size());
+
+        byId_[idCell(id)] = static_cast<std::uint32_t>(index + 1);
+        byName_[nameCell(name, hash)] = tag(hash) | (index + 1);
+
+        if (index % 4096 == 0)
+            availableWords_.push_back(0);
+        if (index % 64 == 0)
+            availableBits_.push_back(0);
+        if (quantity > 0)
+            markAvailable(index);
+        return index;
+    }
+
+    /* ---------- lookup ---------- */
+
+    /**
+     * @brief Index of a SKU id, or npos
+     */
+    std::size_t find(Sku id) const {
+        const std::uint32_t entry = byId_[idCell(id)];
+        return entry ? entry - 1 : npos;
+    }
+
+    /**
+     * @brief Index of a product name, or npos
+     */
+    std::size_t findByName(std::string_view name) const {
+        const std::uint64_t entry = byName_[nameCell(name, hashName(name))];
+        return entry ? static_cast<std::uint32_t>(entry) - 1 : npos;
+    }
+
+    /* ---------- by index (same calls as Inventory) ---------- */
+
+    /**
+     * @brief Sells one unit of a product
+     */
+    bool sell(std::size_t index) {
+        if (index >= quantities_.size() || quantities_[index] == 0)
+            return false;
+
+        if (--quantities_[index] == 0)
+            markSoldOut(index);
+        ++sold_[index];
+        return true;
+    }
+
+    /**
+     * @brief Sells a whole multi-item order, or nothing
+     *
+     * Lines are checked first, then taken from stock one by one; a
+     * short line puts the earlier ones back, so an order naming the
+     * same product twice is handled too.
+     */
+    OrderResult sellBatch(OrderView order) {
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            if (order[i].index >= quantities_.size())
+                return {OrderStatus::InvalidItem, i};
+            if (order[i].quantity <= 0)
+                return {OrderStatus::InvalidQuantity, i};
+        }
+
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const OrderLine& line = order[i];
+            if (quantities_[line.index] < line.quantity) {
+                const std::size_t failed = i;
+                while (i-- > 0) {
+                    if (quantities_[order[i].index] == 0)
+                        markAvailable(order[i].index);
+                    quantities_[order[i].index] += order[i].quantity;
+                    sold_[order[i].index] -= order[i].quantity;
+                }
+                return {OrderStatus::OutOfStock, failed};
+            }
+            if ((quantities_[line.index] -= line.quantity) == 0)
+                markSoldOut(line.index);
+            sold_[line.index] += line.quantity;
+        }
+        return {OrderStatus::Ok, 0};
+    }
+
+    /**
+     * @brief Adds `units` to a product
+     */
+    void restock(std::size_t index, int units) {
+        if (index >= quantities_.size() || units <= 0)
+            return;
+        if (quantities_[index] == 0)
+            markAvailable(index);
+        quantities_[index] += units;
+    }
+
+    /**
+     * @brief Overwrites a product's counters (used when loading a snapshot)
+     */
+    void setStock(std::size_t index, int quantity, int sold) {
+        if (index >= quantities_.size())
+            return;
+        if (quantity < 0)
+            quantity = 0;
+        if (quantities_[index] == 0 && quantity > 0)
+            markAvailable(index);
+        else if (quantities_[index] > 0 && quantity == 0)
+            markSoldOut(index);
+        quantities_[index] = quantity;
+        sold_[index] = sold;
+    }
+
+    /**
+     * @brief Exact total of everything sold so far
+     */
+    Money revenue() const {
+        return Money::dot(prices_.data(), sold_.data(), prices_.size());
+    }
+
+    Money price(std::size_t index) const {
+        return (index < prices_.size()) ? prices_[index] : Money();
+    }
+
+    int quantity(std::size_t index) const {
+        return (index < quantities_.size()) ? quantities_[index] : -1;
+    }
+
+    int sold(std::size_t index) const {
+        return (index < sold_.size()) ? sold_[index] : 0;
+    }
+
+    Sku sku(std::size_t index) const {
+        return ids_[index];
+    }
+
+    /**
+     * @brief Product name, a view into the catalog's name arena
+     */
+    std::string_view name(std::size_t index) const {
+        if (index >= nameRefs_.size())
+            return "Invalid";
+        return std::string_view(names_.data() + nameRefs_[index].offset,
+                                nameRefs_[index].length);
+    }
+
+    /**
+     * @brief Checks if any product is available, O(1)
+     */
+    bool hasStock() const {
+        return inStock_ > 0;
+    }
+
+    /**
+     * @brief Number of products in stock, O(1)
+     */
+    std::size_t inStockCount() const {
+        return inStock_;
+    }
+
+    /**
+     * @brief Calls `f(index)` for every product in stock, in index order
+     *
+     * O(available + size() / 4096).
+     */
+    template <class F>
+    void forEachAvailable(F&& f) const {
+        for (std::size_t top = 0; top < availableWords_.size(); ++top) {
+            for (std::uint64_t words = availableWords_[top]; words != 0; words &= words - 1) {
+                const std::size_t word = top * 64 + static_cast<std::size_t>(__builtin_ctzll(words));
+                for (std::uint64_t bits = availableBits_[word]; bits != 0; bits &= bits - 1)
+                    f(word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits)));
+            }
+        }
+    }
+
+    std::size_t size() const {
+        return ids_.size();
+    }
+
+    /**
+     * @brief Heap bytes held by the arrays, the arena and the indexes
+     */
+    std::size_t memoryBytes() const {
+        return ids_.capacity() * sizeof(Sku) +
+               prices_.capacity() * sizeof(Money) +
+               (quantities_.capacity() + sold_.capacity()) * sizeof(int) +
+               nameRefs_.capacity() * sizeof(NameRef) +
+               names_.capacity() +
+               byId_.capacity() * sizeof(std::uint32_t) +
+               (byName_.capacity() + availableBits_.capacity() + availableWords_.capacity()) *
+                   sizeof(std::uint64_t);
+    }
+};
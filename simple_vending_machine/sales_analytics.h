@@ -0,0 +1,342 @@
+/**
+ * @file sales_analytics.h
+ * @brief Sliding-window sales rates and bestsellers, fed by the sell path.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <time.h>
+
+/* ============================================================
+   SALES ANALYTICS
+   Concept: Ring buckets + space-saving + single-writer seqlock
+   ============================================================ */
+
+/**
+ * @class SalesAnalytics
+ * @brief Per-product sales over the last minute / hour / day, and the top K.
+ *
+ * Windows: every product has three rings of time buckets,
+ *
+ *   minute: 60 buckets of 1 s    hour: 60 buckets of 1 min
+ *   day:    24 buckets of 1 h
+ *
+ * Each bucket is one 64-bit word, bucket epoch in the high half and
+ * units in the low half. A record bumps one bucket per ring and
+ * restarts a bucket lazily when it finds an old epoch in it, so there
+ * is no background rotation and memory is constant: 144 words per
+ * product. A window query sums the buckets whose epoch still falls
+ * inside it, so it covers the current partial bucket plus the full
+ * ones before it.
+ *
+ * Bestsellers: a space-saving summary of `counters` entries in a
+ * min-heap. A product not yet tracked replaces the smallest entry and
+ * inherits its count as error, so every reported count overestimates
+ * by at most `error` <= total units / counters. Every kPublishEvery
+ * records (and on publish()) the top K are copied out under a seqlock.
+ *
+ * Threads: record() and publish() belong to one writer, the sell
+ * path; any number of other threads may query at the same time.
+ * Readers never lock or write shared state - bucket words are read
+ * atomically, and a top-K copy that raced a publish is simply retried
+ * - so a query can never stall a sale.
+ */
+class SalesAnalytics {
+
+public:
+
+    enum class Window { Minute, Hour, Day };
+
+    /**
+     * @struct Bestseller
+     * @brief One top-K entry; the true count is in [units - error, units].
+     */
+    struct Bestseller {
+        std::size_t index;
+        std::uint64_t units;
+        std::uint64_t error;
+    };
+
+    /// Records between two top-K publications
+    static constexpr std::uint64_t kPublishEvery = 4096;
+
+private:
+
+    /**
+     * @struct Ring
+     * @brief Geometry of one window.
+     */
+    struct Ring {
+        std::uint32_t offset;    ///< first bucket within a product's buckets
+        std::uint32_t buckets;
+        std::uint32_t seconds;   ///< per bucket
+    };
+
+    static constexpr Ring kRings[3] = {
+        {0, 60, 1},          // minute
+        {60, 60, 60},        // hour
+        {120, 24, 3600}      // day
+    };
+
+    static constexpr std::size_t kBucketsPerProduct = 144;
+
+    /**
+     * @struct Counter
+     * @brief One space-saving entry.
+     */
+    struct Counter {
+        std::uint64_t units;
+        std::uint64_t error;
+        std::uint32_t index;
+    };
+
+    std::size_t products_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> buckets_;
+    std::int64_t start_;    ///< clock seconds at construction
+
+    /* ---------- writer only ---------- */
+    std::vector<Counter> heap_;                ///< min-heap by units
+    std::vector<std::uint32_t> position_;      ///< per product: heap index + 1, 0 = untracked
+    std::size_t counters_;
+    std::vector<Counter> ranking_;             ///< scratch for publish()
+    std::uint64_t events_{0};
+
+    /* ---------- published top K (seqlock) ---------- */
+    std::size_t topK_;
+    alignas(64) std::atomic<std::uint64_t> version_{0};
+    std::atomic<std::size_t> published_{0};
+    std::unique_ptr<std::atomic<std::uint64_t>[]> top_;   ///< index, units, error per entry
+
+    static std::int64_t clockSeconds() {
+        // Coarse clock: a few ns per call, tick resolution well under 1 s
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<std::int64_t>(ts.tv_sec);
+    }
+
+    static void bump(std::atomic<std::uint64_t>& bucket, std::uint32_t epoch, std::uint32_t units) {
+        std::uint64_t v = bucket.load(std::memory_order_relaxed);
+        v = (v >> 32 == epoch) ? v + units : (std::uint64_t{epoch} << 32 | units);
+        bucket.store(v, std::memory_order_relaxed);   // single writer: no RMW needed
+    }
+
+    void place(std::size_t i) {
+        position_[heap_[i].index] = static_cast<std::uint32_t>(i + 1);
+    }
+
+    void siftUp(std::size_t i) {
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / 2;
+            if (heap_[parent].units <= heap_[i].units)
+                break;
+            std::swap(heap_[parent], heap_[i]);
+            place(i);
+            i = parent;
+        }
+        place(i);
+    }
+
+    void siftDown(std::size_t i) {
+        const std::size_t n = heap_.size();
+        for (;;) {
+            std::size_t smallest = i;
+            const std::size_t left = 2 * i + 1;
+            const std::size_t right = left + 1;
+            if (left < n && heap_[left].units < heap_[smallest].units)
+                smallest = left;
+            if (right < n && heap_[right].units < heap_[smallest].units)
+                smallest = right;
+            if (smallest == i)
+                break;
+            std::swap(heap_[smallest], heap_[i]);
+            place(i);
+            i = smallest;
+        }
+        place(i);
+    }
+
+    void count(std::size_t index, std::uint32_t units) {
+        if (std::uint32_t p = position_[index]) {
+            heap_[p - 1].units += units;
+            siftDown(p - 1);
+        } else if (heap_.size() < counters_) {
+            heap_.push_back({units, 0, static_cast<std::uint32_t>(index)});
+            siftUp(heap_.size() - 1);
+        } else {
+            // Space-saving: the newcomer takes over the smallest counter
+            Counter& min = heap_.front();
+            position_[min.index] = 0;
+            min.error = min.units;
+            min.units += units;
+            min.index = static_cast<std::uint32_t>(index);
+            siftDown(0);
+        }
+    }
+
+public:
+
+    /**
+     * @param products  number of product indexes that will be recorded
+     * @param topK      bestsellers published to readers
+     * @param counters  space-saving entries (0 = 64 per published one)
+     */
+    explicit SalesAnalytics(std::size_t products, std::size_t topK = 10, std::size_t counters = 0)
+        : products_(products),
+          buckets_(new std::atomic<std::uint64_t>[products * kBucketsPerProduct]()),
+          start_(clockSeconds()),
+          position_(products, 0),
+          counters_(std::max(counters ? counters : 64 * topK, topK)),
+          topK_(topK),
+          top_(new std::atomic<std::uint64_t>[3 * topK]()) {
+        if (products > UINT32_MAX)
+            throw std::length_error("SalesAnalytics: too many products.");
+        heap_.reserve(counters_);
+        ranking_.reserve(counters_);
+    }
+
+    SalesAnalytics(const SalesAnalytics&) = delete;
+    SalesAnalytics& operator=(const SalesAnalytics&) = delete;
+
+    /**
+     * @brief Seconds since construction: the time base of every query.
+     */
+    std::uint32_t now() const {
+        return static_cast<std::uint32_t>(clockSeconds() - start_);
+    }
+
+    /* ---------- writer ---------- */
+
+    /**
+     * @brief Counts `units` sold of product `index` at time `second`.
+     *
+     * Times must not go backwards (a late record lands in the current
+     * bucket of a ring it is too old for).
+     */
+    void record(std::size_t index, int units, std::uint32_t second) {
+        if (index >= products_ || units <= 0)
+            return;
+        const auto u = static_cast<std::uint32_t>(units);
+
+        std::atomic<std::uint64_t>* b = &buckets_[index * kBucketsPerProduct];
+        for (const Ring& ring : kRings) {
+            const std::uint32_t epoch = second / ring.seconds;
+            bump(b[ring.offset + epoch % ring.buckets], epoch, u);
+        }
+
+        count(index, u);
+        if (++events_ % kPublishEvery == 0)
+            publish();
+    }
+
+    void record(std::size_t index, int units = 1) {
+        record(index, units, now());
+    }
+
+    /**
+     * @brief Copy the current top K out to readers.
+     */
+    void publish() {
+        ranking_.assign(heap_.begin(), heap_.end());
+        const std::size_t n = std::min(topK_, ranking_.size());
+        std::partial_sort(ranking_.begin(), ranking_.begin() + static_cast<std::ptrdiff_t>(n),
+                          ranking_.end(), [](const Counter& a, const Counter& b) {
+                              return a.units > b.units;
+                          });
+
+        const std::uint64_t v = version_.load(std::memory_order_relaxed);
+        version_.store(v + 1, std::memory_order_relaxed);    // odd: publishing
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < n; ++i) {
+            top_[3 * i].store(ranking_[i].index, std::memory_order_relaxed);
+            top_[3 * i + 1].store(ranking_[i].units, std::memory_order_relaxed);
+            top_[3 * i + 2].store(ranking_[i].error, std::memory_order_relaxed);
+        }
+        published_.store(n, std::memory_order_relaxed);
+        version_.store(v + 2, std::memory_order_release);
+    }
+
+    /// Records so far (writer's count)
+    std::uint64_t events() const {
+        return events_;
+    }
+
+    /* ---------- readers (any thread) ---------- */
+
+    /**
+     * @brief Units of product `index` sold within `window` as of `second`.
+     */
+    std::uint64_t unitsIn(std::size_t index, Window window, std::uint32_t second) const {
+        if (index >= products_)
+            return 0;
+        const Ring& ring = kRings[static_cast<int>(window)];
+        const std::uint32_t current = second / ring.seconds;
+        const std::atomic<std::uint64_t>* b = &buckets_[index * kBucketsPerProduct + ring.offset];
+
+        std::uint64_t total = 0;
+        for (std::uint32_t i = 0; i < ring.buckets; ++i) {
+            const std::uint64_t v = b[i].load(std::memory_order_relaxed);
+            const auto epoch = static_cast<std::uint32_t>(v >> 32);
+            if (epoch <= current && current - epoch < ring.buckets)
+                total += v & 0xffffffffu;
+        }
+        return total;
+    }
+
+    std::uint64_t unitsIn(std::size_t index, Window window) const {
+        return unitsIn(index, window, now());
+    }
+
+    /**
+     * @brief Average units per second over the full window length.
+     */
+    double rate(std::size_t index, Window window) const {
+        const Ring& ring = kRings[static_cast<int>(window)];
+        return static_cast<double>(unitsIn(index, window)) /
+               (static_cast<double>(ring.buckets) * ring.seconds);
+    }
+
+    /**
+     * @brief Copies the last published top K, best first.
+     * @return entries written to `out` (at most `max`)
+     */
+    std::size_t bestsellers(Bestseller* out, std::size_t max) const {
+        for (;;) {
+            const std::uint64_t v1 = version_.load(std::memory_order_acquire);
+            if (v1 & 1)
+                continue;   // publish in progress; it is short
+
+            const std::size_t n = std::min(max, published_.load(std::memory_order_relaxed));
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i].index = static_cast<std::size_t>(top_[3 * i].load(std::memory_order_relaxed));
+                out[i].units = top_[3 * i + 1].load(std::memory_order_relaxed);
+                out[i].error = top_[3 * i + 2].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version_.load(std::memory_order_relaxed) == v1)
+                return n;
+        }
+    }
+
+    std::vector<Bestseller> bestsellers() const {
+        std::vector<Bestseller> top(topK_);
+        top.resize(bestsellers(top.data(), top.size()));
+        return top;
+    }
+
+    std::size_t size() const {
+        return products_;
+    }
+
+    std::size_t memoryBytes() const {
+        return products_ * (kBucketsPerProduct * sizeof(std::uint64_t) + sizeof(std::uint32_t)) +
+               counters_ * 2 * sizeof(Counter) + topK_ * 3 * sizeof(std::uint64_t);
+    }
+};
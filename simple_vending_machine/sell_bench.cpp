@@ -0,0 +1,108 @@
+/**
+ * @file sell_bench.cpp
+ * @brief Sells per second of ConcurrentInventory as buyer threads grow.
+ *
+ * @details
+ * Every run starts a fresh ConcurrentInventory with enough stock for
+ * about three quarters of all attempts, then lets 1, 2, 4, ... N
+ * buyer threads call sell() on random drinks until each has made its
+ * attempts. The run reports attempts per second and checks that
+ * nothing was oversold: the units sold must equal the stock loaded,
+ * every quantity must be zero and sold() must match the successes the
+ * threads counted.
+ *
+ * The single-threaded Inventory is timed first as a baseline.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 -pthread sell_bench.cpp -o sell_bench
+ * ./sell_bench [max_threads] [attempts_per_thread]   (default: cores 2000000)
+ */
+
+#include "concurrent_inventory.h"
+#include "inventory.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char* argv[]) {
+
+    unsigned hw = std::thread::hardware_concurrency();
+    int maxThreads = (argc > 1) ? std::atoi(argv[1]) : static_cast<int>(hw ? hw : 4);
+    long perThread = (argc > 2) ? std::atol(argv[2]) : 2'000'000L;
+
+    std::cout << "Sell attempts per thread: " << perThread << "\n";
+
+    // Baseline: plain Inventory, one thread
+    {
+        const int stock = static_cast<int>(perThread * 3 / 4 / 3);
+        Inventory inventory(stock);
+        std::mt19937 rng(1);
+
+        long sold = 0;
+        auto start = Clock::now();
+        for (long i = 0; i < perThread; ++i)
+            sold += inventory.sell(rng() % 3);
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        std::cout << "Inventory (single-threaded): "
+                  << static_cast<long>(perThread / elapsed.count()) << " sells/s"
+                  << ", sold " << sold << "\n";
+    }
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+
+        const long attempts = perThread * threads;
+        const int stock = static_cast<int>(attempts * 3 / 4 / 3);
+        ConcurrentInventory inventory(stock);
+
+        std::atomic<long> successes{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> buyers;
+
+        for (int t = 0; t < threads; ++t) {
+            buyers.emplace_back([&, t] {
+                std::mt19937 rng(static_cast<unsigned>(t) + 1);
+                long sold = 0;
+
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+
+                for (long i = 0; i < perThread; ++i)
+                    sold += inventory.sell(rng() % 3);
+                successes += sold;
+            });
+        }
+
+        auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread& b : buyers)
+            b.join();
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        long recorded = 0;
+        bool empty = true;
+        for (std::size_t i = 0; i < inventory.size(); ++i) {
+            recorded += inventory.sold(i);
+            empty = empty && inventory.quantity(i) == 0;
+        }
+        const long loaded = static_cast<long>(stock) * static_cast<long>(inventory.size());
+        const bool consistent = empty && recorded == loaded && successes.load() == loaded;
+
+        std::cout << threads << " thread(s): "
+                  << static_cast<long>(attempts / elapsed.count()) << " sells/s"
+                  << ", sold " << successes.load() << " of " << loaded
+                  << ", " << (consistent ? "no oversell" : "OVERSOLD") << "\n";
+
+        if (!consistent)
+            return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file stock_bench.cpp
+ * @brief hasStock() and "list available items": scan vs maintained bitmap.
+ *
+ * @details
+ * 1. A ProductCatalog of N products where all but `available` have
+ *    been sold out by sells and orders (the survivors sit at the end,
+ *    the worst case for a scan). Times hasStock() and listing the
+ *    available products, once by scanning every quantity (how
+ *    hasStock() used to work) and once through the maintained count
+ *    and bitmap, and checks that both lists match.
+ * 2. A ConcurrentInventory hammered by buyer threads and one restocker
+ *    thread; after each round the availability bits must match the
+ *    quantities exactly.
+ *
+ * @usage
+ * g++ -std=c++17 -O2 -pthread stock_bench.cpp -o stock_bench
+ * ./stock_bench [products] [available] [threads]   (default: 1000000 100 4)
+ */
+
+#include "concurrent_inventory.h"
+#include "order.h"
+#include "product_catalog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+double nanosSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+
+    std::size_t products = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    std::size_t available = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 100;
+    int threads = (argc > 3) ? std::atoi(argv[3]) : 4;
+    available = std::min(available, products);
+
+    // 1. Catalog: scan vs maintained availability
+    ProductCatalog catalog;
+    catalog.reserve(products);
+    for (std::size_t i = 0; i < products; ++i)
+        catalog.add(i, "product-" + std::to_string(i), Money::fromCents(100), 2);
+
+    // Sell out everything but the last `available` products, half by
+    // single sells, half by orders
+    const std::size_t soldOut = products - available;
+    for (std::size_t i = 0; i < soldOut; i += 2) {
+        if (i % 4 == 0 || i + 1 == soldOut) {
+            catalog.sell(i);
+            catalog.sell(i);
+            if (i + 1 < soldOut) {
+                catalog.sell(i + 1);
+                catalog.sell(i + 1);
+            }
+        } else {
+            const OrderLine order[] = {{i, 2}, {i + 1, 2}};
+            catalog.sellBatch(order);
+        }
+    }
+
+    const int rounds = 100;
+    std::size_t sink = 0;
+
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        bool any = false;
+        for (std::size_t i = 0; i < catalog.size() && !any; ++i)
+            any = catalog.quantity(i) > 0;
+        sink += any;
+    }
+    const double scanHasStock = nanosSince(start) / rounds;
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        sink += catalog.hasStock();
+    const double fastHasStock = nanosSince(start) / rounds;
+
+    std::vector<std::size_t> scanned;
+    std::vector<std::size_t> listed;
+    scanned.reserve(available);
+    listed.reserve(available);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        scanned.clear();
+        for (std::size_t i = 0; i < catalog.size(); ++i) {
+            if (catalog.quantity(i) > 0)
+                scanned.push_back(i);
+        }
+    }
+    const double scanList = nanosSince(start) / rounds;
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        listed.clear();
+        catalog.forEachAvailable([&](std::size_t i) { listed.push_back(i); });
+    }
+    const double fastList = nanosSince(start) / rounds;
+
+    const bool listsMatch = scanned == listed && listed.size() == catalog.inStockCount();
+
+    std::cout << "Catalog: " << products << " products, " << catalog.inStockCount()
+              << " in stock\n"
+              << "  hasStock():   scan " << scanHasStock << " ns, maintained "
+              << fastHasStock << " ns\n"
+              << "  list in stock: scan " << scanList / 1000 << " us, bitmap "
+              << fastList / 1000 << " us (" << (listsMatch ? "lists match" : "LISTS DIFFER")
+              << ")\n";
+
+    // 2. Concurrent inventory: bits must match quantities at rest
+    int mismatches = 0;
+    long sells = 0;
+    for (int round = 0; round < 200; ++round) {
+        ConcurrentInventory inventory(50);
+        std::atomic<bool> stop{false};
+        std::atomic<long> sold{0};
+        std::vector<std::thread> buyers;
+
+        for (int t = 0; t < threads; ++t) {
+            buyers.emplace_back([&, t] {
+                std::mt19937 rng(static_cast<unsigned>(round * 64 + t));
+                long mine = 0;
+                for (int i = 0; i < 2000; ++i) {
+                    if (rng() % 4 == 0) {
+                        const OrderLine order[] = {{rng() % 3, 2}, {rng() % 3, 1}};
+                        mine += inventory.sellBatch(order).ok() ? 3 : 0;
+                    } else {
+                        mine += inventory.sell(rng() % 3);
+                    }
+                }
+                sold += mine;
+            });
+        }
+        std::thread restocker([&] {
+            std::mt19937 rng(static_cast<unsigned>(round));
+            while (!stop.load(std::memory_order_relaxed)) {
+                inventory.restock(rng() % 3, 1 + static_cast<int>(rng() % 3));
+                std::this_thread::yield();
+            }
+        });
+
+        for (std::thread& b : buyers)
+            b.join();
+        stop = true;
+        restocker.join();
+        sells += sold.load();
+
+        std::size_t inStock = 0;
+        std::vector<std::size_t> bits;
+        inventory.forEachAvailable([&](std::size_t i) { bits.push_back(i); });
+        for (std::size_t i = 0; i < inventory.size(); ++i) {
+            const bool bit = std::find(bits.begin(), bits.end(), i) != bits.end();
+            inStock += inventory.quantity(i) > 0;
+            mismatches += bit != (inventory.quantity(i) > 0);
+        }
+        mismatches += inStock != inventory.inStockCount();
+        mismatches += (inStock > 0) != inventory.hasStock();
+    }
+
+    std::cout << "Concurrent: 200 rounds, " << threads << " buyers + 1 restocker, "
+              << sells << " units sold, "
+              << (mismatches == 0 ? "availability exact at rest" : "AVAILABILITY MISMATCH")
+              << "\n";
+
+    return (listsMatch && mismatches == 0 && sink != 0) ? 0 : 1;
+}
@@ -0,0 +1,532 @@
+/**
+ * @file stock_journal.h
+ * @brief Write-ahead log + snapshots that make vending stock durable.
+ */
+#pragma once
+
+#include "order.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ============================================================
+   STOCK JOURNAL
+   Concept: Write-ahead logging + checkpointing over mmap
+   ============================================================ */
+
+/**
+ * @class StockJournal
+ * @brief Crash-safe stock of an Inventory or ProductCatalog.
+ *
+ * Two files in one directory:
+ *
+ *   stock.wal   [ header page ][ record 0 ] ... [ record capacity-1 ]
+ *   stock.snap  [ header ][ quantity x products ][ sold x products ]
+ *
+ * Every sell and restock becomes one 16-byte record written straight
+ * into the mapped log; an order becomes one record per product, the
+ * last one marked, and is replayed only if all of them made it.
+ * Records go to disk with msync() once per `groupSize` appends (group
+ * commit) or when flush() is called.
+ *
+ * When the log is full, snapshot() writes the stock arrays to a new
+ * snapshot file, renames it over the old one and reuses the log from
+ * the start. Recovery maps the snapshot, copies it into the catalog
+ * and replays at most `capacity` records after it, so restart time
+ * depends on the catalog size and the log capacity, never on how many
+ * sales the machine has seen.
+ *
+ * Works with any catalog offering size(), quantity(i), sold(i),
+ * setStock(i, quantity, sold), sellBatch(OrderView) and
+ * restock(i, units). One writer per journal.
+ */
+class StockJournal {
+
+public:
+
+    enum class RecordType : std::uint8_t {
+        Sell    = 1,
+        Restock = 2
+    };
+
+private:
+
+    /**
+     * @struct Record
+     * @brief One stock change, four per cache line.
+     */
+    struct Record {
+        std::uint32_t sequence;    ///< low 32 bits of the 1-based sequence
+        std::uint32_t index;       ///< product index
+        std::int32_t units;
+        RecordType type;
+        std::uint8_t last;         ///< 1 = ends its order (or stands alone)
+        std::uint16_t checksum;
+    };
+
+    static_assert(sizeof(Record) == 16, "four records per cache line");
+
+    struct LogHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint64_t capacity;
+    };
+
+    struct SnapshotHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+        std::uint64_t products;
+        std::uint64_t sequence;    ///< last record folded into the snapshot
+        std::uint64_t checksum;    ///< over this header and the payload
+    };
+
+    static constexpr char kLogMagic[8] = {'V', 'M', 'S', 'T', 'W', 'A', 'L', '1'};
+    static constexpr char kSnapshotMagic[8] = {'V', 'M', 'S', 'T', 'S', 'N', 'P', '1'};
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kHeaderBytes = 4096;
+
+    std::string dir_;
+    std::string logPath_;
+    std::string snapshotPath_;
+
+    int fd_{-1};
+    unsigned char* base_{nullptr};
+    std::size_t mappedBytes_{0};
+
+    Record* records_{nullptr};
+    std::size_t capacity_{0};
+
+    std::size_t cursor_{0};        ///< next record index
+    std::size_t syncedUpTo_{0};    ///< records [0, syncedUpTo_) are on disk
+    std::size_t groupSize_;
+    std::uint64_t sequence_{0};    ///< last written sequence number
+
+    std::vector<OrderLine> pending_;       ///< order being replayed
+    std::vector<std::int32_t> scratch_;    ///< snapshot payload
+
+    static std::uint16_t checksum(Record record) {
+        record.checksum = 0;
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&record);
+        std::uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < sizeof(record); ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return static_cast<std::uint16_t>(hash ^ (hash >> 16));
+    }
+
+    /**
+     * @brief 64-bit FNV-style hash, one multiply per 8 bytes.
+     *
+     * Byte-wise FNV would cost milliseconds on a large snapshot;
+     * `bytes` must be a multiple of 8.
+     */
+    static std::uint64_t checksum(const void* data, std::size_t bytes, std::uint64_t hash) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < bytes; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p + i, sizeof(word));
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+    static std::uint64_t checksum(SnapshotHeader header, const void* payload, std::size_t bytes) {
+        header.checksum = 0;
+        return checksum(payload, bytes, checksum(&header, sizeof(header), 14695981039346656037ULL));
+    }
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::runtime_error("StockJournal: " + what + " (" + std::strerror(errno) + ")");
+    }
+
+    /**
+     * @brief msync() the pages covering a byte range of the mapping.
+     */
+    void sync(std::size_t offset, std::size_t bytes) {
+        static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t begin = offset / page * page;
+        if (msync(base_ + begin, offset + bytes - begin, MS_SYNC) != 0)
+            fail("msync failed");
+    }
+
+    void append(RecordType type, std::size_t index, int units, bool last) {
+        if (cursor_ >= capacity_)
+            throw std::length_error("StockJournal: log full, snapshot first.");
+
+        Record& r = records_[cursor_];
+        r.sequence = static_cast<std::uint32_t>(++sequence_);
+        r.index = static_cast<std::uint32_t>(index);
+        r.units = units;
+        r.type = type;
+        r.last = last ? 1 : 0;
+        r.checksum = checksum(r);
+        ++cursor_;
+    }
+
+    void committed() {
+        if (cursor_ - syncedUpTo_ >= groupSize_)
+            flush();
+    }
+
+    /**
+     * @brief Zero and sync every record after the cursor.
+     *
+     * Records past the end of a replay are stale or were never
+     * acknowledged. New appends reuse their sequence numbers, so after
+     * a second crash one of them could line up and be replayed; zeroed,
+     * none can. Only the span up to the last non-zero record is written.
+     */
+    void discardTail() {
+        static const Record kZero{};
+        std::size_t end = capacity_;
+        while (end > cursor_ && std::memcmp(&records_[end - 1], &kZero, sizeof(Record)) == 0)
+            --end;
+        if (end == cursor_)
+            return;
+        std::memset(static_cast<void*>(&records_[cursor_]), 0, (end - cursor_) * sizeof(Record));
+        sync(kHeaderBytes + cursor_ * sizeof(Record), (end - cursor_) * sizeof(Record));
+    }
+
+    static void writeAll(int fd, const void* data, std::size_t bytes, const std::string& path) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        while (bytes > 0) {
+            ssize_t n = ::write(fd, p, bytes);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                fail("cannot write " + path);
+            p += n;
+            bytes -= static_cast<std::size_t>(n);
+        }
+    }
+
+    void open(std::size_t capacity) {
+        if (::mkdir(dir_.c_str(), 0755) != 0 && errno != EEXIST)
+            fail("cannot create " + dir_);
+
+        fd_ = ::open(logPath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            fail("cannot open " + logPath_);
+
+        struct stat st {};
+        if (fstat(fd_, &st) != 0)
+            fail("cannot stat " + logPath_);
+
+        const bool fresh = st.st_size == 0;
+        if (!fresh) {
+            if (static_cast<std::size_t>(st.st_size) < kHeaderBytes + sizeof(Record))
+                throw std::runtime_error("StockJournal: " + logPath_ + " is truncated.");
+            capacity = (static_cast<std::size_t>(st.st_size) - kHeaderBytes) / sizeof(Record);
+        }
+
+        mappedBytes_ = kHeaderBytes + capacity * sizeof(Record);
+        if (fresh && ftruncate(fd_, static_cast<off_t>(mappedBytes_)) != 0)
+            fail("cannot size " + logPath_);
+
+        void* p = mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED)
+            fail("cannot map " + logPath_);
+
+        base_ = static_cast<unsigned char*>(p);
+        records_ = reinterpret_cast<Record*>(base_ + kHeaderBytes);
+        capacity_ = capacity;
+
+        auto* header = reinterpret_cast<LogHeader*>(base_);
+        if (fresh) {
+            std::memcpy(header->magic, kLogMagic, sizeof(kLogMagic));
+            header->version = kVersion;
+            header->recordSize = sizeof(Record);
+            header->capacity = capacity_;
+            sync(0, kHeaderBytes);
+        } else if (std::memcmp(header->magic, kLogMagic, sizeof(kLogMagic)) != 0 ||
+                   header->version != kVersion ||
+                   header->recordSize != sizeof(Record)) {
+            throw std::runtime_error("StockJournal: " + logPath_ + " has an unknown format.");
+        }
+    }
+
+    void close() {
+        if (base_)
+            munmap(base_, mappedBytes_);
+        if (fd_ >= 0)
+            ::close(fd_);
+        base_ = nullptr;
+        fd_ = -1;
+    }
+
+    /**
+     * @brief Map the snapshot and copy it into the catalog.
+     * @return false if there is no snapshot yet
+     */
+    template <class Catalog>
+    bool loadSnapshot(Catalog& catalog) {
+        int fd = ::open(snapshotPath_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == ENOENT)
+                return false;
+            fail("cannot open " + snapshotPath_);
+        }
+
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail("cannot stat " + snapshotPath_);
+        }
+        const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+        if (bytes < sizeof(SnapshotHeader)) {
+            ::close(fd);
+            throw std::runtime_error("StockJournal: " + snapshotPath_ + " is truncated.");
+        }
+
+        void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            fail("cannot map " + snapshotPath_);
+        madvise(p, bytes, MADV_SEQUENTIAL);
+
+        const auto* header = static_cast<const SnapshotHeader*>(p);
+        const auto* quantities = reinterpret_cast<const std::int32_t*>(header + 1);
+        const std::size_t payload = bytes - sizeof(SnapshotHeader);
+
+        const char* problem = nullptr;
+        if (std::memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+            header->version != kVersion)
+            problem = " has an unknown format.";
+        else if (payload != header->products * 2 * sizeof(std::int32_t))
+            problem = " is truncated.";
+        else if (header->checksum != checksum(*header, quantities, payload))
+            problem = " is corrupt.";
+        else if (header->products != catalog.size())
+            problem = " was written for another catalog.";
+
+        if (problem) {
+            munmap(p, bytes);
+            throw std::runtime_error("StockJournal: " + snapshotPath_ + problem);
+        }
+
+        const std::int32_t* sold = quantities + header->products;
+        for (std::size_t i = 0; i < header->products; ++i)
+            catalog.setStock(i, quantities[i], sold[i]);
+        sequence_ = header->sequence;
+
+        munmap(p, bytes);
+        return true;
+    }
+
+public:
+
+    /**
+     * @brief Open (or create) the journal in directory `dir`.
+     * @param capacity  log records between two snapshots (new logs only)
+     * @param groupSize appends per msync() (group commit)
+     */
+    explicit StockJournal(const std::string& dir,
+                          std::size_t capacity = 1 << 18,
+                          std::size_t groupSize = 256)
+        : dir_(dir),
+          logPath_(dir + "/stock.wal"),
+          snapshotPath_(dir + "/stock.snap"),
+          groupSize_(groupSize ? groupSize : 1) {
+        try {
+            open(capacity ? capacity : 1);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    ~StockJournal() {
+        if (base_)
+            msync(base_, mappedBytes_, MS_SYNC);
+        close();
+    }
+
+    StockJournal(const StockJournal&) = delete;
+    StockJournal& operator=(const StockJournal&) = delete;
+
+    /**
+     * @brief Rebuild the stock from the snapshot + log tail.
+     * @return false if there is no snapshot yet (fresh journal)
+     *
+     * Replay stops at the first stale or torn record; an order whose
+     * last record is missing is dropped. Leaves the append cursor
+     * right after the last replayed record, with the rest of the log
+     * zeroed.
+     */
+    template <class Catalog>
+    bool recover(Catalog& catalog) {
+        cursor_ = 0;
+        syncedUpTo_ = 0;
+        if (!loadSnapshot(catalog)) {
+            discardTail();
+            return false;
+        }
+
+        std::size_t scan = 0;
+        std::uint64_t sequence = sequence_;
+        pending_.clear();
+
+        while (scan < capacity_) {
+            const Record& r = records_[scan];
+            if (r.sequence != static_cast<std::uint32_t>(sequence + 1) ||
+                r.checksum != checksum(r))
+                break;
+            ++sequence;
+            ++scan;
+
+            if (r.type == RecordType::Sell) {
+                pending_.push_back({r.index, r.units});
+                if (!r.last)
+                    continue;
+                if (!catalog.sellBatch(pending_).ok())
+                    throw std::runtime_error("StockJournal: log does not match the snapshot.");
+                pending_.clear();
+            } else {
+                catalog.restock(r.index, r.units);
+            }
+
+            sequence_ = sequence;
+            cursor_ = scan;
+        }
+
+        pending_.clear();
+        syncedUpTo_ = cursor_;
+        discardTail();
+        return true;
+    }
+
+    /**
+     * @brief Write a snapshot of the catalog and restart the log.
+     *
+     * The snapshot is written to a temporary file, synced and renamed
+     * over the previous one, so a crash half-way leaves the old
+     * snapshot and its log intact.
+     */
+    template <class Catalog>
+    void snapshot(const Catalog& catalog) {
+        const std::size_t products = catalog.size();
+        scratch_.resize(products * 2);
+        for (std::size_t i = 0; i < products; ++i) {
+            scratch_[i] = catalog.quantity(i);
+            scratch_[products + i] = catalog.sold(i);
+        }
+        const std::size_t payload = scratch_.size() * sizeof(std::int32_t);
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        header.version = kVersion;
+        header.products = products;
+        header.sequence = sequence_;
+        header.checksum = checksum(header, scratch_.data(), payload);
+
+        const std::string temp = snapshotPath_ + ".tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            fail("cannot create " + temp);
+        try {
+            writeAll(fd, &header, sizeof(header), temp);
+            writeAll(fd, scratch_.data(), payload, temp);
+            if (fsync(fd) != 0)
+                fail("cannot sync " + temp);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+
+        if (std::rename(temp.c_str(), snapshotPath_.c_str()) != 0)
+            fail("cannot rename " + temp);
+        int dirFd = ::open(dir_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd < 0)
+            fail("cannot open " + dir_);
+        try {
+            if (fsync(dirFd) != 0)
+                fail("cannot sync " + dir_);
+        } catch (...) {
+            ::close(dirFd);
+            throw;
+        }
+        ::close(dirFd);
+
+        cursor_ = 0;
+        syncedUpTo_ = 0;
+    }
+
+    /**
+     * @brief True when the log is full and needs a snapshot.
+     */
+    bool needsSnapshot() const {
+        return cursor_ >= capacity_;
+    }
+
+    /**
+     * @brief True if `records` more records fit before the next snapshot.
+     */
+    bool fits(std::size_t records) const {
+        return records <= capacity_ - cursor_;
+    }
+
+    /**
+     * @brief Log appenders, called after the change was applied.
+     */
+    void appendSell(std::size_t index, int units = 1) {
+        append(RecordType::Sell, index, units, true);
+        committed();
+    }
+
+    void appendRestock(std::size_t index, int units) {
+        append(RecordType::Restock, index, units, true);
+        committed();
+    }
+
+    /**
+     * @brief One record per line; replayed all-or-nothing.
+     */
+    void appendOrder(OrderView order) {
+        if (order.size() == 0)
+            return;
+        if (!fits(order.size()))
+            throw std::length_error("StockJournal: order does not fit the log, snapshot first.");
+        for (std::size_t i = 0; i < order.size(); ++i)
+            append(RecordType::Sell, order[i].index, order[i].quantity, i + 1 == order.size());
+        committed();
+    }
+
+    /**
+     * @brief Force every appended record to disk.
+     */
+    void flush() {
+        if (cursor_ > syncedUpTo_) {
+            sync(kHeaderBytes + syncedUpTo_ * sizeof(Record),
+                 (cursor_ - syncedUpTo_) * sizeof(Record));
+            syncedUpTo_ = cursor_;
+        }
+    }
+
+    std::uint64_t sequence() const {
+        return sequence_;
+    }
+
+    std::size_t capacity() const {
+        return capacity_;
+    }
+
+    /// Records written since the last snapshot
+    std::size_t logged() const {
+        return cursor_;
+    }
+};
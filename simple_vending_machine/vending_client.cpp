@@ -0,0 +1,197 @@
+/**
+ * @file vending_client.cpp
+ * @brief Load tester for the vending machine's socket front-end.
+ *
+ * @details
+ * Opens N sessions to the machine's Unix socket from one thread and
+ * one epoll loop. Every session keeps one purchase in flight: it
+ * sends a random drink number, waits for the reply line, and sends
+ * the next one at once. So N is the number of concurrent customers.
+ *
+ * Reports purchases per second and request latency percentiles
+ * (p50 / p99 / p99.9 / max), the reply mix, and checks that every
+ * request got exactly one reply.
+ *
+ * Start the machine with plenty of stock first, e.g.:
+ *   ./vending_machine /tmp/vending.sock 100000000 < /dev/null
+ *
+ * @usage
+ * g++ -std=c++17 -O2 vending_client.cpp -o vending_client
+ * ./vending_client [socket_path] [sessions] [seconds]
+ *                  (default: /tmp/vending.sock 2000 3)
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @struct Customer
+ * @brief One session and its request in flight.
+ */
+struct Customer {
+    int fd{-1};
+    Clock::time_point sentAt;
+    std::string in;
+    bool waiting{false};
+};
+
+int connectTo(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "socket");
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "connect " + path);
+    }
+    return fd;
+}
+
+void sendRequest(Customer& c, std::mt19937& rng) {
+    // Mostly valid drinks, now and then a bad number
+    char line[4] = {static_cast<char>('0' + rng() % 4), '\n'};
+    if (::send(c.fd, line, 2, MSG_NOSIGNAL) != 2)
+        throw std::system_error(errno, std::generic_category(), "send");
+    c.sentAt = Clock::now();
+    c.waiting = true;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string path = (argc > 1) ? argv[1] : "/tmp/vending.sock";
+    int sessions = (argc > 2) ? std::atoi(argv[2]) : 2000;
+    double seconds = (argc > 3) ? std::atof(argv[3]) : 3.0;
+    sessions = std::max(sessions, 1);
+
+    std::vector<Customer> customers(static_cast<std::size_t>(sessions));
+    std::vector<std::uint64_t> latencies;   // ns; 32 bits would wrap at 4.3 s
+    latencies.reserve(1 << 22);
+
+    long dispensed = 0;
+    long soldOut = 0;
+    long invalid = 0;
+    long unexpected = 0;
+
+    try {
+        int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll < 0)
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+
+        std::mt19937 rng(21);
+        for (int i = 0; i < sessions; ++i) {
+            Customer& c = customers[static_cast<std::size_t>(i)];
+            c.fd = connectTo(path);
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u32 = static_cast<std::uint32_t>(i);
+            if (::epoll_ctl(epoll, EPOLL_CTL_ADD, c.fd, &ev) < 0)
+                throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+        }
+
+        const auto start = Clock::now();
+        const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                          std::chrono::duration<double>(seconds));
+
+        for (Customer& c : customers)
+            sendRequest(c, rng);
+
+        epoll_event events[256];
+        long inFlight = sessions;
+        while (inFlight > 0) {
+            int n = ::epoll_wait(epoll, events, 256, 2000);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                throw std::runtime_error("Machine stopped answering.");
+
+            const auto now = Clock::now();
+            const bool more = now < deadline;
+
+            for (int e = 0; e < n; ++e) {
+                Customer& c = customers[events[e].data.u32];
+                char buf[4096];
+                ssize_t got = ::recv(c.fd, buf, sizeof(buf), 0);
+                if (got <= 0)
+                    throw std::runtime_error("Machine closed a session.");
+                c.in.append(buf, static_cast<std::size_t>(got));
+
+                std::size_t end;
+                while ((end = c.in.find('\n')) != std::string::npos) {
+                    const std::string_view reply(c.in.data(), end);
+                    if (!c.waiting)
+                        ++unexpected;
+                    else if (reply.rfind("Dispensed", 0) == 0)
+                        ++dispensed;
+                    else if (reply.find("out of stock") != std::string_view::npos)
+                        ++soldOut;
+                    else if (reply == "Invalid selection!")
+                        ++invalid;
+                    else
+                        ++unexpected;
+
+                    latencies.push_back(static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now - c.sentAt).count()));
+                    c.waiting = false;
+                    c.in.erase(0, end + 1);
+                }
+
+                if (!c.waiting) {
+                    if (more)
+                        sendRequest(c, rng);
+                    else
+                        --inFlight;
+                }
+            }
+        }
+
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        for (Customer& c : customers)
+            ::close(c.fd);
+        ::close(epoll);
+
+        std::sort(latencies.begin(), latencies.end());
+        auto at = [&latencies](double q) -> double {
+            if (latencies.empty())
+                return 0;
+            return latencies[static_cast<std::size_t>(
+                       q * static_cast<double>(latencies.size() - 1))] / 1000.0;
+        };
+
+        std::cout << "Sessions: " << sessions << "\n"
+                  << "Purchases: " << latencies.size() << " in " << elapsed.count() << " s ("
+                  << static_cast<long>(static_cast<double>(latencies.size()) / elapsed.count())
+                  << " /s)\n"
+                  << "Replies: dispensed " << dispensed << ", out of stock " << soldOut
+                  << ", invalid " << invalid << ", unexpected " << unexpected << "\n"
+                  << "Latency: p50 " << at(0.50) << " us, p99 " << at(0.99)
+                  << " us, p99.9 " << at(0.999) << " us, max " << at(1.0) << " us\n";
+
+        return unexpected ? 1 : 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[EXCEPTION] " << e.what() << "\n";
+        return 1;
+    }
+}
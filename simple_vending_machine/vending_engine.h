@@ -0,0 +1,554 @@
+/**
+ * @file vending_engine.h
+ * @brief Event-driven purchase engine: many input sources, one epoll loop.
+ */
+#pragma once
+
+#include "inventory.h"
+
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* ============================================================
+   SESSION
+   ============================================================ */
+
+/**
+ * @class Session
+ * @brief One purchase source: an input fd, an output fd and buffers.
+ *
+ * A source is a line-based stream - stdin, a pipe or FIFO, or a
+ * connected Unix socket (then input and output are the same fd).
+ * Every line is one purchase request, the drink number, and gets
+ * exactly one reply line back, in order:
+ *
+ *   "Dispensed Coke for $0.55 (9 left)"
+ *   "Coke is out of stock."
+ *   "Invalid selection!"
+ *
+ * An interactive session (a person at stdin) also gets the menu and
+ * a prompt after every reply.
+ */
+class Session {
+
+public:
+
+    /// Bytes read per wakeup: bounds the work one session can queue
+    static constexpr std::size_t kReadChunk = 4096;
+
+    /// Unsent reply bytes above which the session is not read from
+    static constexpr std::size_t kMaxPending = 64 * 1024;
+
+private:
+
+    int in_;
+    int out_;
+    bool owned_;          ///< close the fds on destruction
+    bool socket_;         ///< write with send(MSG_NOSIGNAL)
+    bool interactive_;
+
+    std::string inBuf_;   ///< received, not yet a complete line
+    std::string outBuf_;  ///< replies not yet written
+    std::size_t sent_{0};
+
+    bool inputOpen_{true};
+    bool failed_{false};
+
+public:
+
+    /// Events the session is registered for (0 = not in epoll)
+    std::uint32_t watched{0};
+
+    /// Queued to flush in the current round
+    bool touched{false};
+
+    Session(int in, int out, bool owned, bool socket, bool interactive)
+        : in_(in), out_(out), owned_(owned), socket_(socket), interactive_(interactive) {
+        inBuf_.reserve(kReadChunk);
+        outBuf_.reserve(kReadChunk);
+    }
+
+    ~Session() {
+        if (owned_) {
+            ::close(in_);
+            if (out_ != in_)
+                ::close(out_);
+        }
+    }
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    int in() const { return in_; }
+    int out() const { return out_; }
+    bool interactive() const { return interactive_; }
+    bool inputOpen() const { return inputOpen_; }
+
+    /**
+     * @brief One read of at most kReadChunk bytes.
+     *
+     * Called only when the fd is readable, so it does not block even
+     * on a blocking stdin. End of input or an error closes the input.
+     */
+    void receive() {
+        char buf[kReadChunk];
+        ssize_t n;
+        do {
+            n = ::read(in_, buf, sizeof(buf));
+        } while (n < 0 && errno == EINTR);
+
+        if (n > 0)
+            inBuf_.append(buf, static_cast<std::size_t>(n));
+        else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            inputOpen_ = false;
+    }
+
+    /**
+     * @brief Calls `f(line)` for every complete line, then drops them.
+     *
+     * After end of input a last line without '\n' counts too.
+     */
+    template <class F>
+    void takeLines(F&& f) {
+        std::size_t start = 0;
+        for (;;) {
+            std::size_t end = inBuf_.find('\n', start);
+            if (end == std::string::npos)
+                break;
+            f(std::string_view(inBuf_).substr(start, end - start));
+            start = end + 1;
+        }
+        if (!inputOpen_ && start < inBuf_.size()) {
+            f(std::string_view(inBuf_).substr(start));
+            start = inBuf_.size();
+        }
+        inBuf_.erase(0, start);
+    }
+
+    std::string& output() {
+        return outBuf_;
+    }
+
+    /**
+     * @brief Write pending replies; whatever the fd does not take stays.
+     */
+    void flush() {
+        while (!failed_ && sent_ < outBuf_.size()) {
+            const char* data = outBuf_.data() + sent_;
+            const std::size_t size = outBuf_.size() - sent_;
+            ssize_t n = socket_ ? ::send(out_, data, size, MSG_NOSIGNAL)
+                                : ::write(out_, data, size);
+            if (n > 0) {
+                sent_ += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return;
+            failed_ = true;
+        }
+        if (sent_ == outBuf_.size()) {
+            outBuf_.clear();
+            sent_ = 0;
+        }
+    }
+
+    std::size_t pending() const {
+        return outBuf_.size() - sent_;
+    }
+
+    /// Too many unsent replies: stop reading until they drain
+    bool backlogged() const {
+        return pending() > kMaxPending;
+    }
+
+    /// Nothing more will come in or go out
+    bool finished() const {
+        return failed_ || (!inputOpen_ && pending() == 0);
+    }
+};
+
+/* ============================================================
+   VENDING ENGINE
+   Concept: Event loop + batched processing
+   ============================================================ */
+
+/**
+ * @class VendingEngine
+ * @brief Serves purchase requests from many sessions against one Inventory.
+ *
+ * One thread, one level-triggered epoll loop. Every round:
+ *
+ * 1. waits for readable / writable sessions (and new connections on
+ *    the optional listening socket);
+ * 2. reads at most Session::kReadChunk bytes from each readable one;
+ * 3. turns every complete line into a request of one batch;
+ * 4. runs the whole batch through the inventory, appending each reply
+ *    to its session's output, then flushes the inventory's journal
+ *    (if any) so no customer hears of a sale that is not on disk;
+ * 5. writes each touched session's replies with one write call.
+ *
+ * Fairness and bounded latency come from the limits: a round reads
+ * one chunk from at most kMaxEvents sessions, so one busy source can
+ * never hold up the others for more than a chunk's worth of requests.
+ * A session whose client does not read its replies (more than
+ * Session::kMaxPending unsent) is not read from until they drain.
+ *
+ * Regular files and /dev/null (stdin redirected) cannot be watched by
+ * epoll; they are read every round instead until they end.
+ *
+ * run() returns when the machine is empty, when the stop flag is set,
+ * or when there is no session and no listener left.
+ */
+class VendingEngine {
+
+public:
+
+    static constexpr int kMaxEvents = 256;
+
+private:
+
+    /**
+     * @struct Request
+     * @brief One parsed line of one session
+     */
+    struct Request {
+        Session* session;
+        std::size_t choice;
+        bool valid;
+    };
+
+    Inventory& inventory_;
+
+    int epoll_{-1};
+    int listen_{-1};
+    std::string path_;
+
+    std::unordered_map<int, std::unique_ptr<Session>> sessions_;   ///< by input fd
+    std::vector<Session*> unwatched_;   ///< regular files, read every round
+
+    std::vector<Request> batch_;
+    std::vector<Session*> touched_;
+
+    long requests_{0};
+    long batches_{0};
+    long accepted_{0};
+
+    void watch(Session& s, std::uint32_t events) {
+        if (events == s.watched)
+            return;
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = s.in();
+        const int op = s.watched ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        if (::epoll_ctl(epoll_, op, s.in(), &ev) < 0)
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+        s.watched = events;
+    }
+
+    void touch(Session& s) {
+        if (!s.touched) {
+            s.touched = true;
+            touched_.push_back(&s);
+        }
+    }
+
+    void acceptAll() {
+        for (;;) {
+            int fd = ::accept4(listen_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR)
+                    continue;
+                return;   // EAGAIN, or a client that already gave up
+            }
+            addSession(fd, fd, true, false);
+            ++accepted_;
+        }
+    }
+
+    static void appendNumber(std::string& out, std::uint64_t value) {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, static_cast<std::size_t>(result.ptr - buf));
+    }
+
+    static void appendMoney(std::string& out, Money m) {
+        Money::Rep c = m.cents();
+        if (c < 0) {
+            out += '-';
+            c = -c;
+        }
+        appendNumber(out, static_cast<std::uint64_t>(c / Money::kCentsPerUnit));
+        out += '.';
+        out += static_cast<char>('0' + c % Money::kCentsPerUnit / 10);
+        out += static_cast<char>('0' + c % 10);
+    }
+
+    static Request parse(Session& s, std::string_view line) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+            line.remove_suffix(1);
+        while (!line.empty() && line.front() == ' ')
+            line.remove_prefix(1);
+
+        std::size_t choice = 0;
+        auto result = std::from_chars(line.data(), line.data() + line.size(), choice);
+        bool valid = !line.empty() && result.ec == std::errc() &&
+                     result.ptr == line.data() + line.size();
+        return {&s, choice, valid};
+    }
+
+    void prompt(Session& s) {
+        s.output().append(inventory_.menu()).append("Select drink number: ");
+    }
+
+    /**
+     * @brief Steps 3 and 4: collect the lines of a session into the batch.
+     */
+    void collect(Session& s) {
+        if (s.backlogged())
+            return;
+        s.takeLines([&](std::string_view line) {
+            // A person pressing Enter on an empty line just gets the prompt again
+            if (s.interactive() && line.find_first_not_of(" \r") == std::string_view::npos)
+                return;
+            batch_.push_back(parse(s, line));
+        });
+    }
+
+    void process() {
+        if (batch_.empty())
+            return;
+        ++batches_;
+        requests_ += static_cast<long>(batch_.size());
+
+        for (const Request& r : batch_) {
+            std::string& out = r.session->output();
+
+            if (!r.valid || r.choice >= inventory_.size()) {
+                out.append("Invalid selection!\n");
+            } else if (inventory_.sell(r.choice)) {
+                out.append("Dispensed ").append(inventory_.name(r.choice)).append(" for $");
+                appendMoney(out, inventory_.price(r.choice));
+                out.append(" (");
+                appendNumber(out, static_cast<std::uint64_t>(inventory_.quantity(r.choice)));
+                out.append(" left)\n");
+            } else {
+                out.append(inventory_.name(r.choice)).append(" is out of stock.\n");
+            }
+
+            if (r.session->interactive()) {
+                out += '\n';
+                if (inventory_.hasStock())
+                    prompt(*r.session);
+            }
+            touch(*r.session);
+        }
+        batch_.clear();
+        inventory_.flushJournal();
+    }
+
+    /**
+     * @brief Step 5: write replies, retire finished sessions, adjust interest.
+     */
+    void flushTouched() {
+        for (Session* s : touched_) {
+            s->touched = false;
+            s->flush();
+
+            if (s->finished()) {
+                drop(*s);
+                continue;
+            }
+            // Sockets: read unless backlogged, ask for EPOLLOUT only while
+            // replies are stuck. Other outputs are written blocking.
+            if (s->watched && s->in() == s->out()) {
+                watch(*s, (s->backlogged() || !s->inputOpen() ? 0u : EPOLLIN | EPOLLRDHUP) |
+                          (s->pending() ? EPOLLOUT : 0u));
+            }
+        }
+        touched_.clear();
+    }
+
+    void drop(Session& s) {
+        if (s.watched)
+            ::epoll_ctl(epoll_, EPOLL_CTL_DEL, s.in(), nullptr);
+        for (std::size_t i = 0; i < unwatched_.size(); ++i) {
+            if (unwatched_[i] == &s) {
+                unwatched_[i] = unwatched_.back();
+                unwatched_.pop_back();
+                break;
+            }
+        }
+        sessions_.erase(s.in());
+    }
+
+public:
+
+    explicit VendingEngine(Inventory& inventory) : inventory_(inventory) {
+        epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_ < 0)
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+        batch_.reserve(1024);
+        touched_.reserve(kMaxEvents);
+    }
+
+    ~VendingEngine() {
+        sessions_.clear();
+        if (listen_ >= 0) {
+            ::close(listen_);
+            ::unlink(path_.c_str());
+        }
+        ::close(epoll_);
+    }
+
+    VendingEngine(const VendingEngine&) = delete;
+    VendingEngine& operator=(const VendingEngine&) = delete;
+
+    /**
+     * @brief Serves requests read from `in`, replying to `out`.
+     * @param owned       close the fds when the session ends
+     * @param interactive show the menu and a prompt after every reply
+     *
+     * Sockets are detected and written with MSG_NOSIGNAL.
+     */
+    void addSession(int in, int out, bool owned, bool interactive) {
+        struct stat st{};
+        const bool socket = ::fstat(out, &st) == 0 && S_ISSOCK(st.st_mode);
+
+        auto session = std::make_unique<Session>(in, out, owned, socket, interactive);
+        Session& s = *session;
+        if (!sessions_.emplace(in, std::move(session)).second)
+            throw std::invalid_argument("Input fd already has a session.");
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = in;
+        if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, in, &ev) == 0) {
+            s.watched = ev.events;
+        } else if (errno == EPERM) {
+            unwatched_.push_back(&s);   // regular file or /dev/null: always ready
+        } else {
+            int err = errno;
+            sessions_.erase(in);
+            throw std::system_error(err, std::generic_category(), "epoll_ctl");
+        }
+
+        if (interactive) {
+            prompt(s);
+            touch(s);
+        }
+    }
+
+    /**
+     * @brief Also accepts sessions on a Unix stream socket at `path`.
+     */
+    void listen(const std::string& path) {
+        if (listen_ >= 0)
+            throw std::logic_error("Engine is already listening.");
+        if (path.size() >= sizeof(sockaddr_un::sun_path))
+            throw std::invalid_argument("Socket path too long.");
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "socket");
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(path.c_str());
+
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(fd, SOMAXCONN) < 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "bind/listen " + path);
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "epoll_ctl");
+        }
+        listen_ = fd;
+        path_ = path;
+    }
+
+    /**
+     * @brief Runs the event loop (see class notes for when it returns).
+     */
+    void run(const volatile std::sig_atomic_t& stop) {
+        epoll_event events[kMaxEvents];
+
+        // Replies queued before the loop (first prompts)
+        flushTouched();
+
+        while (!stop && inventory_.hasStock() && (!sessions_.empty() || listen_ >= 0)) {
+            const int timeout = unwatched_.empty() ? 500 : 0;
+            int n = ::epoll_wait(epoll_, events, kMaxEvents, timeout);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "epoll_wait");
+            }
+
+            // 1-2: read
+            for (int i = 0; i < n; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == listen_) {
+                    acceptAll();
+                    continue;
+                }
+                auto it = sessions_.find(fd);
+                if (it == sessions_.end())
+                    continue;
+                Session& s = *it->second;
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                    s.receive();
+                touch(s);
+            }
+            for (Session* s : unwatched_) {
+                s->receive();
+                touch(*s);
+            }
+
+            // 3-4: one batch for the whole round
+            for (Session* s : touched_)
+                collect(*s);
+            process();
+
+            // 5: write
+            flushTouched();
+        }
+
+        // Let every session see its last replies
+        for (auto& [fd, s] : sessions_) {
+            (void)fd;
+            s->flush();
+        }
+    }
+
+    long requests() const { return requests_; }
+    long batches() const { return batches_; }
+    long accepted() const { return accepted_; }
+};
@@ -4,131 +4,103 @@
  *
  * Demonstrates:
  *  - Encapsulation and abstraction
- *  - std::array and std::string
+ *  - std::array and std::string (see inventory.h)
  *  - Const-correct member functions
+ *  - Exact prices with the shared Money type (integer cents)
+ *  - Event-driven purchase flow (see vending_engine.h)
+ *  - Durable stock: write-ahead log + snapshots (see stock_journal.h)
+ *  - Sliding-window sales statistics (see sales_analytics.h)
  *  - Clean, safe C++17 coding style
  *
  * @author Suman
  * @date 2026
  */
 
+#include "inventory.h"
+#include "sales_analytics.h"
+#include "stock_journal.h"
+#include "vending_engine.h"
+
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
-#include <array>
+#include <memory>
 #include <string>
-#include <sstream>
 
-/**
- * @class Inventory
- * @brief Manages drinks inside the vending machine
- */
-class Inventory {
-private:
-    /**
-     * @struct Drink
-     * @brief Represents a single drink item
-     */
-    struct Drink {
-        std::string name;
-        double price;
-        int quantity;
-    };
-
-    /// Fixed-size inventory 
-    std::array<Drink, 3> drinks{
-        Drink{"Coke",  0.55, 10},
-        Drink{"Pepsi", 0.45, 10},
-        Drink{"Water", 0.85, 10}
-    };
-
-public:
-    /**
-     * @brief Returns formatted drink menu
-     */
-    std::string menu() const {
-        std::ostringstream out;
-        out << "\nAvailable Drinks:\n";
-        for (std::size_t i = 0; i < drinks.size(); ++i) {
-            out << i << ": " << drinks[i].name
-                << " ($" << drinks[i].price << ")\n";
-        }
-        return out.str();
-    }
+#include <unistd.h>
 
-    /**
-     * @brief Sells one unit of a drink
-     */
-    bool sell(std::size_t index) {
-        if (index >= drinks.size() || drinks[index].quantity == 0)
-            return false;
+namespace {
 
-        --drinks[index].quantity;
-        return true;
-    }
-
-    /**
-     * @brief Checks if any drink is available
-     */
-    bool hasStock() const {
-        for (const auto& d : drinks) {
-            if (d.quantity > 0)
-                return true;
-        }
-        return false;
-    }
+volatile std::sig_atomic_t gStop = 0;
 
-    /**
-     * @brief Returns remaining quantity
-     */
-    int quantity(std::size_t index) const {
-        return (index < drinks.size()) ? drinks[index].quantity : -1;
-    }
-
-    /**
-     * @brief Returns drink name
-     */
-    std::string name(std::size_t index) const {
-        return (index < drinks.size()) ? drinks[index].name : "Invalid";
-    }
+void onSignal(int) {
+    gStop = 1;
+}
 
-    /**
-     * @brief Number of selectable drinks
-     */
-    std::size_t size() const {
-        return drinks.size();
-    }
-};
+} // namespace
 
 /**
  * @brief Program entry point
+ *
+ * Serves the person at stdin and, with a socket path, any number of
+ * clients on that Unix socket at the same time (one drink number per
+ * line, one reply line each; an empty path serves stdin only).
+ * Optional second argument: units of each drink to start with.
+ * Optional third argument: a state directory; the stock is then
+ * journaled there and survives restarts (the second argument only
+ * applies to a fresh directory).
  */
-int main() {
-    Inventory inventory;
-    std::size_t choice{};
+int main(int argc, char* argv[]) {
+    std::string socketPath = (argc > 1) ? argv[1] : "";
+    int stock = (argc > 2) ? std::atoi(argv[2]) : 10;
+    std::string stateDir = (argc > 3) ? argv[3] : "";
 
-    std::cout << "=== Suman Vending Machine ===\n";
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
 
-    while (inventory.hasStock()) {
-        std::cout << inventory.menu();
-        std::cout << "Select drink number: ";
+    Inventory inventory(stock);
+    SalesAnalytics analytics(inventory.size(), inventory.size());
+    inventory.attachAnalytics(analytics);
 
-        std::cin >> choice;
+    std::cout << "=== Suman Vending Machine ===\n" << std::flush;
 
-        if (choice >= inventory.size()) {
-            std::cout << "Invalid selection!\n\n";
-            continue;
+    // Outlives the try block: the inventory keeps a pointer to it
+    std::unique_ptr<StockJournal> journal;
+
+    try {
+        if (!stateDir.empty()) {
+            journal = std::make_unique<StockJournal>(stateDir);
+            inventory.attachJournal(*journal);
         }
 
-        if (inventory.sell(choice)) {
-            std::cout << "Dispensed "
-                      << inventory.name(choice)
-                      << " (" << inventory.quantity(choice)
-                      << " left)\n\n";
-        } else {
-            std::cout << inventory.name(choice)
-                      << " is out of stock.\n\n";
+        VendingEngine engine(inventory);
+        engine.addSession(STDIN_FILENO, STDOUT_FILENO, false, true);
+        if (!socketPath.empty())
+            engine.listen(socketPath);
+        engine.run(gStop);
+
+        if (!socketPath.empty()) {
+            std::cout << "\nSessions: " << engine.accepted()
+                      << ", requests: " << engine.requests()
+                      << ", batches: " << engine.batches() << "\n";
+
+            analytics.publish();
+            std::cout << "Bestsellers this run:\n";
+            for (const SalesAnalytics::Bestseller& b : analytics.bestsellers())
+                std::cout << "  " << inventory.name(b.index) << ": " << b.units
+                          << " sold, " << analytics.rate(b.index, SalesAnalytics::Window::Minute)
+                          << "/s over the last minute\n";
         }
     }
+    catch (const std::exception& e) {
+        std::cerr << "[EXCEPTION] " << e.what() << "\n";
+        return 1;
+    }
 
-    std::cout << "*** Machine Empty — Thank You ***\n";
+    if (inventory.hasStock())
+        std::cout << "\n";   // input ended at the prompt
+    else
+        std::cout << "*** Machine Empty — Thank You ***\n";
+    std::cout << "Total sales: $" << inventory.revenue() << "\n";
     return 0;
 }